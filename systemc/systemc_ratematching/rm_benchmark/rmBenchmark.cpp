@@ -0,0 +1,239 @@
+/*
+ * ==============================================
+ * File:        rmBenchmark.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Micro-benchmark of the standalone rate
+ *              matching library. Reports the output rate in
+ *              Mbit/s for BG1 and BG2 code blocks over every
+ *              modulation order and redundancy version, the
+ *              portable and SIMD interleaving kernels per Qm
+ *              (checked bit-exact against each other), the
+ *              kernels specialised per Qm against the generic
+ *              path, then the scaling of the parallel batch with the
+ *              number of threads.
+ *
+ * Usage: rm_benchmark [seconds per configuration, default 0.2]
+ * ==============================================
+ */
+
+#include "rmBatch.h"
+#include "rmParallel.h"
+#include "rmDerate.h"
+#include "rmDispatch.h"
+#include "rmSimd.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Mbit/s (or million values per second) of fn, run for at least minSeconds
+template <typename F>
+static double rate(double minSeconds, double bitsPerCall, F fn) {
+    fn();
+    long long iterations = 0;
+    double seconds = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (seconds < minSeconds) {
+        for (int i = 0; i < 16; ++i) {
+            fn();
+        }
+        iterations += 16;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return bitsPerCall * iterations / seconds / 1e6;
+}
+
+// Portable or BMI2 specialised interleaving kernel for an even Qm
+static rmInterleaveFn fixedKernel(int Qm, bool bmi2) {
+    switch (Qm) {
+    case 2: return bmi2 ? rmInterleaveBitsBmi2Fixed<2> : rmInterleaveBitsFixed<2>;
+    case 4: return bmi2 ? rmInterleaveBitsBmi2Fixed<4> : rmInterleaveBitsFixed<4>;
+    case 6: return bmi2 ? rmInterleaveBitsBmi2Fixed<6> : rmInterleaveBitsFixed<6>;
+    case 8: return bmi2 ? rmInterleaveBitsBmi2Fixed<8> : rmInterleaveBitsFixed<8>;
+    case 10: return bmi2 ? rmInterleaveBitsBmi2Fixed<10> : rmInterleaveBitsFixed<10>;
+    default: return bmi2 ? nullptr : rmInterleaveBitsFixed<1>;
+    }
+}
+
+int main(int argc, char* argv[]) {
+
+    double minSeconds = (argc > 1) ? std::atof(argv[1]) : 0.2;
+
+    const int C = 8;                     // Code blocks per transport block
+    const int Zc = 384;
+    const int bgN[2] = { 66 * Zc, 50 * Zc };
+    const int QmVec[] = { 1, 2, 4, 6, 8, 10 };
+
+    std::mt19937_64 rng(1);
+    rmBatch batch;
+
+    std::printf("%-4s %-4s %-3s %-8s %-8s %10s\n", "BG", "Qm", "rv", "N", "E", "Mbit/s");
+
+    for (int bg = 0; bg < 2; ++bg) {
+        int N = bgN[bg];
+        int cbWords = rmNumWords(N);
+
+        std::vector<uint64_t> cb((size_t)C * cbWords);
+        for (uint64_t& w : cb) {
+            w = rng();
+        }
+
+        for (int Qm : QmVec) {
+            for (int rv = 0; rv < 4; ++rv) {
+                // About 1.2 N bits per code block, a whole number of symbols
+                rmTbConfig cfg;
+                cfg.N = N;
+                cfg.rv = rv;
+                cfg.Qm = Qm;
+                cfg.C = C;
+                cfg.G = C * ((N * 6 / 5) / Qm) * Qm;
+
+                std::vector<uint64_t> out(rmNumWords(cfg.G + C * cfg.nlayers * Qm));
+
+                // Warm up the plan cache and the work buffers
+                int bits = batch.rateMatch(cfg, cb.data(), out.data());
+
+                long long iterations = 0;
+                double seconds = 0;
+                auto start = std::chrono::steady_clock::now();
+                while (seconds < minSeconds) {
+                    for (int i = 0; i < 16; ++i) {
+                        batch.rateMatch(cfg, cb.data(), out.data());
+                    }
+                    iterations += 16;
+                    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                }
+
+                double mbps = (double)bits * iterations / seconds / 1e6;
+                std::printf("%-4d %-4d %-3d %-8d %-8d %10.1f\n", bg + 1, Qm, rv, N, bits / C, mbps);
+            }
+        }
+    }
+
+    // Portable and SIMD kernels per Qm on 4096 rows
+    std::printf("\nInterleaving kernels, 4096 rows (BMI2 %s, SSSE3 %s)\n",
+                rmHaveBmi2() ? "yes" : "no", rmHaveSsse3() ? "yes" : "no");
+    std::printf("%-4s %12s %12s %14s %14s %6s\n", "Qm", "bits Mbit/s", "bits SIMD", "LLR Mval/s", "LLR SIMD", "Exact");
+
+    bool exact = true;
+    for (int Qm : QmVec) {
+        if (Qm < 2) {
+            continue;
+        }
+        int E = 4096 * Qm;
+        int nWords = rmNumWords(E);
+        std::vector<uint64_t> e(nWords), a(nWords), b(nWords);
+        std::vector<int8_t> llr(E), x(E), y(E);
+        for (uint64_t& w : e) {
+            w = rng();
+        }
+        for (int8_t& v : llr) {
+            v = (int8_t)rng();
+        }
+
+        double bitScalar = rate(minSeconds, E, [&] { rmInterleaveBitsScalar(e.data(), E, Qm, a.data()); });
+        double llrScalar = rate(minSeconds, E, [&] { rmDeinterleaveScalar(llr.data(), E, Qm, x.data()); });
+        double bitSimd = 0, llrSimd = 0;
+        bool same = true;
+        if (rmHaveBmi2()) {
+            bitSimd = rate(minSeconds, E, [&] { rmInterleaveBitsBmi2(e.data(), E, Qm, b.data()); });
+            same = same && (a == b);
+        }
+        if (rmHaveSsse3()) {
+            llrSimd = rate(minSeconds, E, [&] { rmDeinterleaveSsse3(llr.data(), E, Qm, y.data()); });
+            same = same && (x == y);
+        }
+        exact = exact && same;
+        std::printf("%-4d %12.1f %12.1f %14.1f %14.1f %6s\n", Qm, bitScalar, bitSimd, llrScalar, llrSimd, same ? "yes" : "NO");
+    }
+
+    // Generic rmInterleaveBits against the kernels specialised per Qm, and
+    // the one the dispatch table picks for the plans
+    std::printf("\nSpecialised interleaving kernels, 4096 rows, Mbit/s\n");
+    std::printf("%-4s %10s %10s %10s %8s %6s\n", "Qm", "generic", "fixed", "fixed BMI2", "gain", "Exact");
+
+    for (int Qm : QmVec) {
+        int E = 4096 * Qm;
+        int nWords = rmNumWords(E);
+        std::vector<uint64_t> e(nWords), a(nWords), b(nWords);
+        for (uint64_t& w : e) {
+            w = rng();
+        }
+
+        rmInterleaveBitsScalar(e.data(), E, Qm, a.data());
+        double generic = rate(minSeconds, E, [&] { rmInterleaveBits(e.data(), E, Qm, b.data()); });
+        bool same = (a == b);
+
+        rmInterleaveFn fixed = fixedKernel(Qm, false);
+        double fixedRate = rate(minSeconds, E, [&] { fixed(e.data(), E, b.data()); });
+        same = same && (a == b);
+
+        double bmi2Rate = 0;
+        rmInterleaveFn bmi2 = rmHaveBmi2() ? fixedKernel(Qm, true) : nullptr;
+        if (bmi2) {
+            bmi2Rate = rate(minSeconds, E, [&] { bmi2(e.data(), E, b.data()); });
+            same = same && (a == b);
+        }
+
+        rmInterleaveFn picked = rmInterleaveKernel(Qm);
+        double pickedRate = (picked == bmi2) ? bmi2Rate : fixedRate;
+        exact = exact && same;
+        std::printf("%-4d %10.1f %10.1f %10.1f %7.2fx %6s\n", Qm, generic, fixedRate, bmi2Rate, pickedRate / generic,
+                    same ? "yes" : "NO");
+    }
+
+    // Parallel batch: many BG1 transport blocks, Qm = 8, over 1, 2, 4, ... threads
+    const int numTb = 64;
+    rmTbConfig cfg;
+    cfg.N = bgN[0];
+    cfg.Qm = 8;
+    cfg.C = C;
+    cfg.G = C * ((cfg.N * 6 / 5) / cfg.Qm) * cfg.Qm;
+
+    int cbWords = rmNumWords(cfg.N);
+    int outWords = rmNumWords(cfg.G + C * cfg.nlayers * cfg.Qm);
+    std::vector<uint64_t> cb((size_t)numTb * C * cbWords);
+    std::vector<uint64_t> out((size_t)numTb * outWords);
+    for (uint64_t& w : cb) {
+        w = rng();
+    }
+
+    std::vector<rmTbJob> jobs(numTb);
+    for (int t = 0; t < numTb; ++t) {
+        jobs[t].cfg = cfg;
+        jobs[t].cb = cb.data() + (size_t)t * C * cbWords;
+        jobs[t].out = out.data() + (size_t)t * outWords;
+    }
+
+    std::printf("\nParallel batch, %d transport blocks of %d BG1 code blocks, Qm %d\n", numTb, C, cfg.Qm);
+    std::printf("%-8s %10s\n", "Threads", "Mbit/s");
+
+    int maxThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    for (int threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        rmParallelBatch parallel(threads);
+        parallel.run(jobs);
+
+        long long iterations = 0;
+        double seconds = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (seconds < minSeconds) {
+            parallel.run(jobs);
+            ++iterations;
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        double bits = (double)jobs[0].outBits * numTb;
+        std::printf("%-8d %10.1f\n", threads, bits * iterations / seconds / 1e6);
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    return exact ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+/*
+ * ==============================================
+ * File:        rmVectorConvert.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Converts test vectors between the text
+ *              files (io/input configuration and 128-bit
+ *              lines, MATLAB save_128bit_per_line output)
+ *              and the binary vector format read by the
+ *              testbenches.
+ *
+ * Usage:
+ *  rm_vector encode <config.txt> <input.txt> <out.rmv>
+ *      One record per configuration holding its C code blocks.
+ *  rm_vector encode-output <config.txt> <output.txt> <out.rmv>
+ *      One record per configuration holding its rate-matched
+ *      output (expected results).
+ *  rm_vector decode <in.rmv> <lines.txt> [config.txt]
+ *      Back to 128-bit lines, and the configurations.
+ * ==============================================
+ */
+
+#include "rmVector.h"
+#include "rmKernel.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Beats of the record of a configuration
+static size_t recordBeats(const rmVectorRecord& rec, bool output) {
+    int C = rec.codeBlocks();
+    if (!output) {
+        return (size_t)C * ((rec.inlen + 127) / 128);
+    }
+
+    // Concatenated output of the C code blocks
+    int G = rec.tbOutputBits();
+    long long bits = 0;
+    for (int r = 0; r < C; ++r) {
+        bits += rmBlockE(G, C, r, (int)rec.nlayers, (int)rec.Qm);
+    }
+    return (size_t)((bits + 127) / 128);
+}
+
+static int encode(const char* cfgPath, const char* linesPath, const char* outPath, bool output) {
+    std::vector<rmVectorRecord> configs;
+    std::vector<uint64_t> words;
+    if (!rmReadConfigText(cfgPath, configs) || !rmReadTextLines(linesPath, words)) {
+        return 1;
+    }
+
+    rmVectorWriter writer;
+    if (!writer.open(outPath)) {
+        return 1;
+    }
+
+    // The lines of each transport block follow the previous one
+    size_t lines = words.size() / 2;
+    size_t line = 0;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        rmVectorRecord rec = configs[i];
+        size_t beats = recordBeats(rec, output);
+        if (beats == 0 || line + beats > lines || i + 1 == configs.size()) {
+            if (line + beats != lines) {
+                std::cerr << "Warning: Transport block " << i << " takes " << lines - line << " lines, expected "
+                          << beats << std::endl;
+            }
+            beats = lines - line;
+        }
+        rec.beats = (uint32_t)beats;
+        if (!writer.write(rec, words.data() + 2 * line)) {
+            std::cerr << "Error: Could not write " << outPath << std::endl;
+            return 1;
+        }
+        line += beats;
+    }
+    writer.close();
+
+    std::cout << outPath << ": " << configs.size() << " records, " << lines << " beats" << std::endl;
+    return 0;
+}
+
+static void writeConfig(FILE* f, const rmVectorRecord& rec) {
+    std::fprintf(f, "input_length: %u\noutput_length: %u\nredundancy_version: %u\nlayer: %u\n"
+                    "modulation_type: %u\nNref: %u\n",
+                 rec.inlen, rec.outlen, rec.rv, rec.nlayers, rec.Qm, rec.Nref);
+    if (rec.C != 0) {
+        std::fprintf(f, "code_blocks: %u\ntb_output_length: %u\n", rec.C, rec.G);
+    }
+    if (rec.F != 0) {
+        std::fprintf(f, "filler_bits: %u\n", rec.F);
+    }
+}
+
+static int decode(const char* inPath, const char* linesPath, const char* cfgPath) {
+    rmVectorReader reader;
+    if (!reader.open(inPath)) {
+        return 1;
+    }
+    FILE* lines = std::fopen(linesPath, "w");
+    FILE* cfg = (cfgPath != nullptr) ? std::fopen(cfgPath, "w") : nullptr;
+    if (lines == nullptr || (cfgPath != nullptr && cfg == nullptr)) {
+        std::cerr << "Error: Could not open output files" << std::endl;
+        return 1;
+    }
+
+    const int chunkBeats = 256;
+    std::vector<uint64_t> chunk(2 * chunkBeats);
+    char text[130];
+    rmVectorRecord rec;
+    long long records = 0, beats = 0;
+    while (reader.next(rec)) {
+        if (cfg != nullptr) {
+            writeConfig(cfg, rec);
+        }
+        int n;
+        while ((n = reader.read(chunk.data(), chunkBeats)) > 0) {
+            for (int i = 0; i < n; ++i) {
+                rmFormatLine(chunk[2 * i], chunk[2 * i + 1], text);
+                text[128] = '\n';
+                std::fwrite(text, 1, 129, lines);
+            }
+            beats += n;
+        }
+        ++records;
+    }
+    std::fclose(lines);
+    if (cfg != nullptr) {
+        std::fclose(cfg);
+    }
+
+    std::cout << inPath << ": " << records << " records, " << beats << " beats"
+              << (reader.mapped() ? " (mapped)" : " (streamed)") << std::endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 5 && std::strcmp(argv[1], "encode") == 0) {
+        return encode(argv[2], argv[3], argv[4], false);
+    }
+    if (argc == 5 && std::strcmp(argv[1], "encode-output") == 0) {
+        return encode(argv[2], argv[3], argv[4], true);
+    }
+    if ((argc == 4 || argc == 5) && std::strcmp(argv[1], "decode") == 0) {
+        return decode(argv[2], argv[3], (argc == 5) ? argv[4] : nullptr);
+    }
+    std::cerr << "Usage: rm_vector encode <config.txt> <input.txt> <out.rmv>\n"
+                 "       rm_vector encode-output <config.txt> <output.txt> <out.rmv>\n"
+                 "       rm_vector decode <in.rmv> <lines.txt> [config.txt]" << std::endl;
+    return 2;
+}
@@ -0,0 +1,203 @@
+/*
+ * ==============================================
+ * File:        Deratematching.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: De-rate matching module. Inverse of the rate
+ *              matching module: de-interleaves the LLRs of a
+ *              code block and accumulates them into the soft
+ *              buffer of its HARQ process at k0, combining
+ *              repeated bits and retransmissions.
+ *
+ * Variable Descriptions:
+ *  - harqId: HARQ process whose soft buffers are combined into.
+ *  - retransmit: clear on the first transmission of a transport
+ *                block, whose soft buffers start from 0.
+ *  - E: number of LLRs of the code block, from G, C and r as on
+ *       the transmit side.
+ * ==============================================
+ */
+
+#include "Deratematching.h"
+#include "rmKernel.h"
+#include <algorithm>
+#include <sstream>
+
+void deratematching::ingestfunction() {
+
+    ratematchingConfig config;    // Configuration of the transport block being received
+    bool active = false;          // A transport block is bound to config
+    bool rejected = false;        // A configuration did not fit the soft buffers
+    int fill = 0;                 // Ping-pong buffer being filled
+    int cbIndex = 0;              // Index r of the next code block in the transport block
+    int llrCount = 0;             // LLRs received into the buffer being filled
+
+    // Initialize output signals
+    din_ready.write(false);
+    config_ready.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            din_ready.write(false);
+            config_ready.write(false);
+            while (!cfgFifo.empty()) {
+                cfgFifo.pop();
+            }
+            llrFillPhase[0].write(false);
+            llrFillPhase[1].write(false);
+            llrCount = 0;
+            active = false;
+            rejected = false;
+            fill = 0;
+            cbIndex = 0;
+            continue; // Move to next cycle
+        }
+
+        // Configuration input handling, taken on the edge where valid and ready are both high
+        if (config_valid.read() && config_ready.read()) {
+            cfgFifo.push(toRatematchingConfig(config_data.read()));
+        }
+
+        // LLR input handling
+        if (din_valid.read() && din_ready.read()) {
+            sc_lv<128> input_data = din_data.read();
+            std::vector<int8_t>& llr = llrBuffer[fill];
+            for (int i = 0; i < LLR_PER_BEAT && llrCount < (int)llr.size(); ++i) {
+                int hi = 127 - 8 * i;
+                llr[llrCount++] = (int8_t)input_data.range(hi, hi - 7).to_uint();
+            }
+
+            // din_last marks the end of each code block: hand the buffer over
+            if (din_last.read() || llrCount >= (int)llr.size()) {
+                int C = config.codeBlocks();
+
+                // A block cut short by din_last: its missing LLRs are erasures, not
+                // what the previous block left in the buffer
+                int G = config.tbOutputBits();
+                int E = rmBlockE(G, C, cbIndex, config.nlayers, config.Qm);
+                if (llrCount < E) {
+                    std::fill(llr.begin() + llrCount, llr.begin() + E, (int8_t)0);
+                }
+                llrConfig[fill] = config;
+                llrBlockIndex[fill] = cbIndex;
+                cbIndex = (cbIndex + 1 < C) ? cbIndex + 1 : 0;
+                llrFillPhase[fill].write(!llrFillPhase[fill].read());
+                llrCount = 0;
+                fill ^= 1;
+                if (cbIndex == 0) {
+                    active = false;
+                }
+            }
+        }
+
+        // Bind the next queued configuration as soon as the previous transport block ends,
+        // if each of its code blocks has a soft buffer in the pool (Ncb <= inlen values)
+        if (!active && !rejected && !cfgFifo.empty()) {
+            config = cfgFifo.front();
+            cfgFifo.pop();
+            int C = config.codeBlocks();
+            if ((int)config.harqId >= harq.processes() || C > harq.codeBlocks() ||
+                (int)config.inlen > harq.cbSize()) {
+                std::ostringstream msg;
+                msg << "Transport block of HARQ process " << config.harqId << ", " << C << " code blocks of "
+                    << config.inlen << " bits, does not fit the soft buffers of " << harq.processes()
+                    << " processes x " << harq.codeBlocks() << " code blocks of " << harq.cbSize() << " values";
+                rejected = true;
+                SC_REPORT_ERROR(name(), msg.str().c_str());
+            }
+            else {
+                active = true;
+                cbIndex = 0;
+
+                // Room for the longest code block of the transport block, whole beats
+                int G = config.tbOutputBits();
+                int maxE = rmBlockE(G, C, C - 1, config.nlayers, config.Qm);
+                int size = (maxE + LLR_PER_BEAT - 1) / LLR_PER_BEAT * LLR_PER_BEAT;
+                for (int b = 0; b < 2; ++b) {
+                    if ((int)llrBuffer[b].size() < size) {
+                        llrBuffer[b].resize(size);
+                    }
+                }
+            }
+        }
+
+        config_ready.write(!rejected && (int)cfgFifo.size() < cfgFifoDepth);
+        din_ready.write(active && !llrFull(fill));
+    }
+}
+
+void deratematching::deratematchingfunction() {
+
+    int cur = 0;     // Ping-pong LLR buffer to process next
+
+    // Initialize output signals
+    dout_valid.write(false);
+    dout_last.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            dout_valid.write(false);
+            dout_last.write(false);
+            llrFreePhase[0].write(false);
+            llrFreePhase[1].write(false);
+            cur = 0;
+            continue; // Move to next cycle
+        }
+
+        if (!llrFull(cur)) {
+            continue;
+        }
+
+        const ratematchingConfig& config = llrConfig[cur];
+        int r = llrBlockIndex[cur];
+        int p = config.harqId;
+        int C = config.codeBlocks();
+        int G = config.tbOutputBits();
+        int E = rmBlockE(G, C, r, config.nlayers, config.Qm);
+        const rmPlan& plan = planCache.get(config.inlen, config.rv, config.Nref, E, config.Qm, config.F);
+
+        // Combine into the soft buffer of the HARQ process, dropping it on new data
+        if (!config.retransmit) {
+            harq.clear(p, r);
+        }
+        if ((int)scratch.size() < E) {
+            scratch.resize(E);
+        }
+        int16_t* soft = harq.buffer(p, r);
+        rmDerateMatch(plan, llrBuffer[cur].data(), scratch.data(), soft);
+
+        // The LLR buffer goes back to ingest
+        llrFreePhase[cur].write(!llrFreePhase[cur].read());
+        cur ^= 1;
+
+        // Send the Ncb soft values, one beat per cycle while dout_ready is high
+        int beats = (plan.Ncb + SOFT_PER_BEAT - 1) / SOFT_PER_BEAT;
+        for (int beat = 0; beat < beats; ++beat) {
+            sc_lv<128> data;
+            for (int i = 0; i < SOFT_PER_BEAT; ++i) {
+                int n = beat * SOFT_PER_BEAT + i;
+                int hi = 127 - 16 * i;
+                data.range(hi, hi - 15) = (n < plan.Ncb) ? (uint16_t)soft[n] : 0;
+            }
+            dout_data.write(data);
+            dout_valid.write(true);
+            dout_last.write(beat == beats - 1);
+
+            // The beat is taken on the first clock edge that sees dout_ready high
+            do {
+                wait();
+            } while (!dout_ready.read());
+        }
+        dout_valid.write(false);
+        dout_last.write(false);
+    }
+}
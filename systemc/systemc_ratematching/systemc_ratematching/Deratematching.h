@@ -0,0 +1,82 @@
+#ifndef DERATEMATCHING_H
+#define DERATEMATCHING_H
+
+#include <systemc.h>
+#include <iostream>
+#include <vector>
+#include <queue>
+#include "ratematching.h"
+#include "rmDerate.h"
+
+const int LLR_PER_BEAT = 16;             // int8_t LLRs per 128-bit input beat
+const int SOFT_PER_BEAT = 8;             // int16_t soft values per 128-bit output beat
+
+// Receive side counterpart of ratematching. Each code block arrives as E
+// int8_t LLRs, 16 per beat with the first in bits 127..120, din_last on the
+// last beat of the block. It is de-interleaved and combined into the soft
+// buffer of its HARQ process, then the Ncb int16_t soft values are sent,
+// 8 per beat with the first in bits 127..112, dout_last on the last beat.
+SC_MODULE(deratematching) {
+public:
+    // Ports
+    sc_in<bool>                 clk;            // Clock
+    sc_in<bool>                 rst;            // Reset
+
+    sc_in<sc_lv<128>>           din_data;       // 16 LLRs
+    sc_in<bool>                 din_valid;
+    sc_in<bool>                 din_last;       // Last beat of a code block
+    sc_out<bool>                din_ready;
+
+    sc_out<sc_lv<128>>          dout_data;      // 8 soft values
+    sc_out<bool>                dout_valid;
+    sc_out<bool>                dout_last;      // Last beat of a code block
+    sc_in<bool>                 dout_ready;
+
+    sc_in<sc_lv<CFG_WIDTH>>     config_data;    // Same bus as ratematching
+    sc_in<bool>                 config_valid;
+    sc_out<bool>                config_ready;
+
+    // Constructor, the soft buffers of harqProcesses x maxCodeBlocks code blocks are allocated here.
+    // A transport block that does not fit them is rejected with SC_REPORT_ERROR as its
+    // configuration is bound, and neither configurations nor LLRs are taken after it until reset.
+    SC_HAS_PROCESS(deratematching);
+    deratematching(sc_module_name name, int harqProcesses = 16, int maxCodeBlocks = 8)
+        : sc_module(name), harq(harqProcesses, maxCodeBlocks, MAX_CB_SIZE) {
+        SC_THREAD(ingestfunction);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
+
+        SC_THREAD(deratematchingfunction);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
+    }
+
+private:
+    // Configurations received ahead of their transport blocks
+    const int cfgFifoDepth = 4;
+    std::queue<ratematchingConfig> cfgFifo;
+
+    // Ping-pong LLR buffers between ingest and de-rate matching. A buffer is full
+    // while its fill phase, toggled by ingest, differs from its free phase, toggled
+    // by de-rate matching; either thread sees the other's toggle on the next edge.
+    std::vector<int8_t> llrBuffer[2];
+    sc_signal<bool> llrFillPhase[2];
+    sc_signal<bool> llrFreePhase[2];
+    ratematchingConfig llrConfig[2];     // Configuration of the block held in each buffer
+    int llrBlockIndex[2] = { 0, 0 };     // Index r of that block in its transport block
+
+    rmPlanCache planCache;
+    rmHarqPool harq;
+    std::vector<int8_t> scratch;
+
+    // Receives the configurations and LLRs into the ping-pong buffers
+    void ingestfunction();
+
+    // Combines a block into its soft buffer and sends the soft values
+    void deratematchingfunction();
+
+    // Buffer b holds a block for de-rate matching, as of the last clock edge
+    bool llrFull(int b) const { return llrFillPhase[b].read() != llrFreePhase[b].read(); }
+};
+
+#endif // DERATEMATCHING_H
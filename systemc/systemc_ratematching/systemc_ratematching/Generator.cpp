@@ -0,0 +1,369 @@
+/*
+ * ==============================================
+ * File:        Generator.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Constrained-random stimulus generator. Draws
+ *              legal rate matching configurations from a seed
+ *              and sends random code blocks built in memory,
+ *              with no file I/O, so the DUT can be soaked with
+ *              millions of codewords at full rate.
+ * ==============================================
+ */
+
+#include "Generator.h"
+#include "Log.h"
+#include "rmPlan.h"
+#include <algorithm>
+#include <iostream>
+
+// Largest values of the configuration bus fields
+static const int maxNref = 63;          // 6 bits
+static const int maxG = (1 << 24) - 1;  // 24 bits
+static const int maxF = (1 << 14) - 1;  // 14 bits
+
+// Clear bits [from, to) of a packed MSB-first buffer
+static void clearBits(uint64_t* w, int from, int to) {
+    while (from < to) {
+        int off = from & 63;
+        int n = std::min(to - from, 64 - off);
+        w[from >> 6] &= ~((~0ULL << (64 - n)) >> off);
+        from += n;
+    }
+}
+
+template <int WIDTH>
+generator<WIDTH>::generator(sc_module_name name, const generatorConstraints& constraints)
+    : sc_module(name), limits(constraints) {
+    for (int Zc : rmLiftingSizes()) {
+        if (Zc > limits.maxZc) {
+            break;
+        }
+        if (limits.baseGraph != 2) {
+            lengths.push_back(66 * Zc);
+        }
+        if (limits.baseGraph != 1) {
+            lengths.push_back(50 * Zc);
+        }
+    }
+    if (lengths.empty()) {
+        lengths.push_back(66 * rmLiftingSizes()[0]);
+    }
+    rewind();
+
+    SC_THREAD(config_thread);
+    sensitive << clk.pos();
+    async_reset_signal_is(rst, true);
+
+    SC_THREAD(data_thread);
+    sensitive << clk.pos();
+    async_reset_signal_is(rst, true);
+}
+
+template <int WIDTH>
+void generator<WIDTH>::rewind() {
+    cfgRng.seed(limits.seed);
+    dataRng.seed(limits.seed * 0x9E3779B97F4A7C15ULL + 1);
+    pending.clear();
+    pendingBase = 0;
+    cfgSent = 0;
+    dataSent = 0;
+    harqConfig.clear();
+    harqData.clear();
+}
+
+template <int WIDTH>
+ratematchingConfig generator<WIDTH>::draw() {
+    ratematchingConfig config;
+    int N = lengths[std::uniform_int_distribution<int>(0, (int)lengths.size() - 1)(cfgRng)];
+    int bgn;
+    int Zc = rmLiftingSize(N, bgn);
+
+    std::vector<int> rvs;
+    for (int rv = 0; rv < 4; ++rv) {
+        if (limits.rvMask & (1u << rv)) {
+            rvs.push_back(rv);
+        }
+    }
+    int rv = rvs.empty() ? 0 : rvs[std::uniform_int_distribution<int>(0, (int)rvs.size() - 1)(cfgRng)];
+    int nlayers = std::uniform_int_distribution<int>(std::max(limits.minLayers, 1),
+                                                     std::min(limits.maxLayers, 4))(cfgRng);
+    int Qm = limits.Qm.empty() ? 2 : limits.Qm[std::uniform_int_distribution<int>(0, (int)limits.Qm.size() - 1)(cfgRng)];
+    int nq = nlayers * Qm;
+
+    // A soft buffer limit, or filler bits, which must then fit in front of the parity bits
+    int Nref = 0, F = 0;
+    if (std::uniform_real_distribution<double>(0, 1)(cfgRng) < limits.nrefRate) {
+        Nref = std::uniform_int_distribution<int>(1, maxNref)(cfgRng);
+    }
+    else if (limits.maxFiller > 0) {
+        int K = ((bgn == 1) ? 22 : 10) * Zc;
+        F = std::uniform_int_distribution<int>(0, std::min({ limits.maxFiller, K - 2 * Zc, maxF }))(cfgRng);
+    }
+
+    // Per code block output length in [minOutlen, maxOutlen], at least one symbol per layer
+    int minOut = std::max(limits.minOutlen, 1);
+    int maxOut = std::max(std::min(limits.maxOutlen, 65535), minOut);
+    int C = std::uniform_int_distribution<int>(1, std::max(std::min(limits.maxCodeBlocks, 255), 1))(cfgRng);
+    int outlen = std::uniform_int_distribution<int>(minOut, maxOut)(cfgRng);
+
+    config.inlen = N;
+    config.rv = rv;
+    config.nlayers = nlayers;
+    config.Qm = Qm;
+    config.Nref = Nref;
+    config.F = F;
+    if (C == 1) {
+        config.outlen = outlen;
+        config.C = 0;
+        config.G = 0;
+    }
+    else {
+        int G = std::uniform_int_distribution<int>(std::max(C * minOut, C * nq),
+                                                   std::max(std::min(C * maxOut, maxG), C * nq))(cfgRng);
+        config.outlen = 0;
+        config.C = C;
+        config.G = G;
+    }
+
+    // A random HARQ process, whose last codeword is sent again with the new rv or replaced
+    if (limits.retransmitRate > 0) {
+        int p = std::uniform_int_distribution<int>(0, std::min(std::max(limits.harqProcesses, 1), 16) - 1)(cfgRng);
+        bool retransmit = std::uniform_real_distribution<double>(0, 1)(cfgRng) < limits.retransmitRate;
+        auto last = harqConfig.find(p);
+        if (retransmit && last != harqConfig.end()) {
+            config = last->second;
+            config.rv = rv;
+            config.retransmit = true;
+            return config;
+        }
+        config.harqId = p;
+        harqConfig[p] = config;
+    }
+    return config;
+}
+
+template <int WIDTH>
+void generator<WIDTH>::count(const ratematchingConfig& config) {
+    int bgn;
+    rmLiftingSize(config.inlen, bgn);
+    ++bgCount[bgn - 1];
+    ++rvCount[config.rv];
+    ++layerCount[(config.nlayers - 1) & 3];
+    if (config.Qm <= 10) {
+        ++qmCount[config.Qm];
+    }
+    nrefCount += (config.Nref != 0) ? 1 : 0;
+    fillerCount += (config.F != 0) ? 1 : 0;
+    multiBlockCount += (config.C != 0) ? 1 : 0;
+    retransmitCount += config.retransmit ? 1 : 0;
+}
+
+template <int WIDTH>
+const ratematchingConfig& generator<WIDTH>::configAt(long long i) {
+    while (pendingBase + (long long)pending.size() <= i) {
+        pending.push_back(draw());
+    }
+
+    // Drop the configurations both threads are done with
+    long long done = std::min(cfgSent, dataSent);
+    while (pendingBase < done && pendingBase < i) {
+        pending.pop_front();
+        ++pendingBase;
+    }
+    return pending[(size_t)(i - pendingBase)];
+}
+
+template <int WIDTH>
+void generator<WIDTH>::config_thread() {
+
+    // Initial conditions
+    config_data.write(sc_lv<CFG_WIDTH>("0"));
+    config_valid.write(false);
+
+    while (cfgSent < limits.transportBlocks) {
+
+        // Start the sequence again on reset
+        if (rst.read()) {
+            config_valid.write(false);
+            rewind();
+            wait();
+            continue;
+        }
+
+        ratematchingConfig config = configAt(cfgSent);
+        config_data.write(toConfigData(config));
+        config_valid.write(true);
+
+        // The configuration is taken on the first clock edge that sees config_ready high
+        do {
+            wait();
+        } while (!config_ready.read());
+        if (board != nullptr) {
+            board->config(config);
+        }
+        count(config);
+        ++cfgSent;
+    }
+
+    config_valid.write(false);
+}
+
+template <int WIDTH>
+bool generator<WIDTH>::sendBeat(const uint64_t* beat, bool last) {
+    if (rst.read()) {
+        dout_valid.write(false);
+        dout_last.write(false);
+        wait();
+        return false;
+    }
+
+    sc_lv<WIDTH> data;
+    wordsToLv(beat, data);
+    dout_data.write(data);
+    dout_valid.write(true);
+    dout_last.write(last);
+
+    // The beat is taken on the first clock edge that sees dout_ready high
+    do {
+        wait();
+        outStats.sample(true, dout_ready.read());
+    } while (!dout_ready.read());
+    if (board != nullptr) {
+        board->inputBeat(beat);
+    }
+    ++beatsSent;
+    return true;
+}
+
+template <int WIDTH>
+bool generator<WIDTH>::harqStatus(bool& hit) {
+    // No beat is sent meanwhile. The status is taken on the first clock edge that sees harq_valid high
+    dout_valid.write(false);
+    dout_last.write(false);
+    harq_ready.write(true);
+    do {
+        wait();
+        if (rst.read()) {
+            harq_ready.write(false);
+            return false;
+        }
+    } while (!harq_valid.read());
+    hit = harq_hit.read();
+    harq_ready.write(false);
+    return true;
+}
+
+template <int WIDTH>
+void generator<WIDTH>::data_thread() {
+
+    // Initial conditions
+    dout_data.write(sc_lv<WIDTH>("0"));
+    dout_valid.write(false);
+    dout_last.write(false);
+    harq_ready.write(false);
+
+    while (dataSent < limits.transportBlocks) {
+        ratematchingConfig config = configAt(dataSent);
+        int N = config.inlen;
+        int C = config.codeBlocks();
+        int blockLines = (N + sizePort - 1) / sizePort;
+        int blockBeats = (N + WIDTH - 1) / WIDTH;
+
+        // Nothing is sent for a retransmission the DUT takes from its HARQ store
+        bool restart = false;
+        bool stored = false;
+        if (config.retransmit) {
+            restart = !harqStatus(stored);
+        }
+        if (stored) {
+            if (board != nullptr) {
+                board->storedInput();
+            }
+            ++storedCount;
+            ++dataSent;
+            continue;
+        }
+
+        // A retransmission the DUT no longer holds sends the codeword of the process again
+        std::mt19937_64 replayRng;
+        if (config.retransmit && harqData.count(config.harqId) != 0) {
+            replayRng = harqData[config.harqId];
+        }
+        else if (limits.retransmitRate > 0) {
+            harqData[config.harqId] = dataRng;
+        }
+        std::mt19937_64& rng = config.retransmit ? replayRng : dataRng;
+
+        // Random code blocks, zero in the filler bits and the padding of the last beat.
+        // The data is drawn per 128-bit line so every bus width sends the same bits.
+        for (int r = 0; r < C && !restart; ++r) {
+            blockWords.assign(blockBeats * (WIDTH / 64), 0);
+            for (int w = 0; w < 2 * blockLines; ++w) {
+                blockWords[w] = rng();
+            }
+            int bgn;
+            int Zc = rmLiftingSize(N, bgn);
+            int K = ((bgn == 1) ? 22 : 10) * Zc;
+            clearBits(blockWords.data(), std::max(K - 2 * Zc - (int)config.F, 0), K - 2 * Zc);
+            clearBits(blockWords.data(), N, blockLines * sizePort);
+
+            // dout_last on the last beat of each code block
+            for (int b = 0; b < blockBeats; ++b) {
+                if (!sendBeat(&blockWords[b * (WIDTH / 64)], b == blockBeats - 1)) {
+                    restart = true;
+                    break;
+                }
+            }
+            ++codeBlocks;
+        }
+
+        // Reset: the config thread rewinds the sequence, follow it from the start
+        if (restart) {
+            dataSent = 0;
+            codeBlocks = 0;
+            beatsSent = 0;
+            continue;
+        }
+        ++dataSent;
+    }
+
+    dout_valid.write(false);
+    dout_last.write(false);
+    RM_LOG(SC_MEDIUM, name(), dataSent << " transport blocks, " << codeBlocks << " code blocks, "
+           << beatsSent << " beats sent");
+}
+
+template <int WIDTH>
+void generator<WIDTH>::writeStats(rmStatsReport& report) const {
+    const std::string module = name();
+    report.add(module, "dout", outStats);
+    report.add(module, "transport_blocks", (double)dataSent);
+    report.add(module, "code_blocks", (double)codeBlocks);
+}
+
+template <int WIDTH>
+void generator<WIDTH>::reportCoverage() const {
+    std::cout << "Generator coverage (seed " << limits.seed << "):" << std::endl;
+    std::cout << "  Base graph 1/2: " << bgCount[0] << " / " << bgCount[1] << std::endl;
+    std::cout << "  rv 0/1/2/3: " << rvCount[0] << " / " << rvCount[1] << " / " << rvCount[2] << " / "
+              << rvCount[3] << std::endl;
+    std::cout << "  Layers 1/2/3/4: " << layerCount[0] << " / " << layerCount[1] << " / " << layerCount[2]
+              << " / " << layerCount[3] << std::endl;
+    std::cout << "  Qm 1/2/4/6/8/10: " << qmCount[1] << " / " << qmCount[2] << " / " << qmCount[4] << " / "
+              << qmCount[6] << " / " << qmCount[8] << " / " << qmCount[10] << std::endl;
+    std::cout << "  Nref limited: " << nrefCount << ", filler bits: " << fillerCount
+              << ", several code blocks: " << multiBlockCount << std::endl;
+    if (limits.retransmitRate > 0) {
+        std::cout << "  HARQ retransmissions: " << retransmitCount << ", from the DUT's store: " << storedCount
+                  << std::endl;
+    }
+}
+
+// Bus widths selectable from sc_main
+#define RM_INSTANTIATE(W) template class generator<W>;
+RM_BUS_WIDTHS(RM_INSTANTIATE)
+#undef RM_INSTANTIATE
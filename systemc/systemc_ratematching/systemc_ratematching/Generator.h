@@ -0,0 +1,129 @@
+// Generator.h
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include "ratematching.h"
+#include "Scoreboard.h"
+#include "rmStats.h"
+#include <deque>
+#include <map>
+#include <random>
+#include <vector>
+
+// Constraints of the random configurations. The defaults cover every legal
+// value of the configuration bus in single block mode.
+struct generatorConstraints {
+    unsigned seed = 1;
+    long long transportBlocks = 1000;        // Configurations to send
+    int baseGraph = 0;                       // 1 or 2 for one base graph only, 0 = both
+    int maxZc = 384;                         // Largest lifting size of the input lengths
+    unsigned rvMask = 0xF;                   // Bit rv set = rv drawn
+    int minLayers = 1, maxLayers = 4;
+    std::vector<int> Qm = { 1, 2, 4, 6, 8, 10 };
+    double nrefRate = 0.25;                  // Share of configurations with a soft buffer limit Nref
+    int minOutlen = 1, maxOutlen = 65535;    // outlen, or G / C for several code blocks
+    int maxCodeBlocks = 1;                   // C drawn from 1..maxCodeBlocks, 1 = single block mode
+    int maxFiller = 0;                       // F drawn from 0..maxFiller when Nref is not used
+    double retransmitRate = 0;               // Share of transport blocks that retransmit a HARQ process
+    int harqProcesses = 8;                   // HARQ processes drawn from, 1..16
+};
+
+// Constrained-random replacement for source: draws legal configurations
+// (TS 38.212 input lengths 66 Zc and 50 Zc, rv, nlayers, Qm, Nref, outlen)
+// from a seed and sends random code blocks generated in memory, one WIDTH-bit
+// beat per cycle while dout_ready is high. A seed always gives the same
+// sequence, whatever the bus width. With a retransmission rate, each
+// transport block goes to a random HARQ process, or retransmits the last
+// codeword of one with a new rv. The DUT reports on harq_hit whether it
+// holds the codeword of a retransmission; when it does not, the codeword is
+// sent again.
+template <int WIDTH = sizePort>
+class generator : public sc_module {
+public:
+    sc_in<bool>                 clk;            // Clock
+    sc_in<bool>                 rst;            // Reset
+
+    sc_out<sc_lv<WIDTH>>        dout_data;      // Output data
+    sc_out<bool>                dout_valid;     // Valid signal from the generator
+    sc_out<bool>                dout_last;
+    sc_in<bool>                 dout_ready;     // Ready signal from RateMatching
+
+    sc_out<sc_lv<CFG_WIDTH>>    config_data;    // Configuration data
+    sc_out<bool>                config_valid;   // Valid signal to RateMatching
+    sc_in<bool>                 config_ready;   // Ready signal from RateMatching
+
+    sc_in<bool>                 harq_valid;     // HARQ status of a retransmission from RateMatching
+    sc_in<bool>                 harq_hit;
+    sc_out<bool>                harq_ready;
+
+    SC_HAS_PROCESS(generator);
+    generator(sc_module_name name, const generatorConstraints& constraints);
+
+    // Number of transport blocks (configurations) that will be sent
+    long long transportBlocks() const { return limits.transportBlocks; }
+
+    // Report every configuration and input beat taken by the DUT
+    void setScoreboard(scoreboard* s) { board = s; }
+
+    // Every transport block has been sent
+    bool done() const { return dataSent >= limits.transportBlocks; }
+
+    // Print how often each parameter value was sent
+    void reportCoverage() const;
+
+    // Add the dout handshake counters to a report
+    void writeStats(rmStatsReport& report) const;
+
+private:
+    const generatorConstraints limits;
+    std::vector<int> lengths;                  // Input lengths allowed by the constraints
+
+    // Configurations drawn but not yet sent by both threads
+    std::mt19937 cfgRng;
+    std::deque<ratematchingConfig> pending;
+    long long pendingBase = 0;                 // Index of pending.front()
+    long long cfgSent = 0, dataSent = 0;       // Transport blocks sent by each thread
+
+    std::mt19937_64 dataRng;
+    std::vector<uint64_t> blockWords;          // Current code block
+
+    // HARQ: last new configuration and data of each process
+    std::map<int, ratematchingConfig> harqConfig;
+    std::map<int, std::mt19937_64> harqData;
+    scoreboard* board = nullptr;
+    rmStreamStats outStats;                    // dout handshakes while a beat is driven
+
+    // Coverage counters, of the configurations taken by the DUT
+    long long bgCount[2] = { 0, 0 };
+    long long rvCount[4] = { 0, 0, 0, 0 };
+    long long layerCount[4] = { 0, 0, 0, 0 };
+    long long qmCount[11] = { 0 };
+    long long nrefCount = 0, fillerCount = 0, multiBlockCount = 0;
+    long long codeBlocks = 0, beatsSent = 0;
+    long long retransmitCount = 0, storedCount = 0;
+
+    // Start the sequence of the seed again
+    void rewind();
+
+    // Configuration of transport block i, drawn when first asked for
+    const ratematchingConfig& configAt(long long i);
+    ratematchingConfig draw();
+
+    // Add a configuration taken by the DUT to the coverage counters
+    void count(const ratematchingConfig& config);
+
+    // Drive one beat and wait until it is taken, false on reset
+    bool sendBeat(const uint64_t* beat, bool last);
+
+    // Wait for the HARQ status of a retransmission, false on reset
+    bool harqStatus(bool& hit);
+
+    // Sends the configurations back to back, ahead of their data
+    void config_thread();
+
+    // Sends the random code blocks
+    void data_thread();
+};
+
+#endif // GENERATOR_H
@@ -0,0 +1,35 @@
+// Log.h
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <systemc.h>
+#include <sstream>
+
+// Messages of the simulation modules go through the SystemC report handler
+// as SC_INFO reports, with the module name as message type and a verbosity:
+//   SC_LOW     run summary
+//   SC_MEDIUM  once per run, the default level (resets, end of data)
+//   SC_HIGH    once per transport block or configuration
+//   SC_FULL    once per code block
+//   SC_DEBUG   once per beat or clock cycle
+//
+// RM_LOG_MAX_VERBOSITY removes the messages above it at compile time, the
+// others are filtered at run time by sc_report_handler::set_verbosity_level.
+// A filtered message costs one comparison, its arguments are not formatted.
+#ifndef RM_LOG_MAX_VERBOSITY
+#define RM_LOG_MAX_VERBOSITY SC_DEBUG
+#endif
+
+// RM_LOG(SC_FULL, name(), "Code block " << r << " of " << C);
+#define RM_LOG(verbosity, id, message)                                          \
+    do {                                                                        \
+        if ((verbosity) <= RM_LOG_MAX_VERBOSITY &&                              \
+            (verbosity) <= sc_report_handler::get_verbosity_level()) {          \
+            std::ostringstream rmLogText;                                       \
+            rmLogText << message;                                               \
+            SC_REPORT_INFO_VERB(id, rmLogText.str().c_str(), verbosity);        \
+        }                                                                       \
+    } while (0)
+
+#endif // LOG_H
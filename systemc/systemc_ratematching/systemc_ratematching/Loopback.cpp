@@ -0,0 +1,276 @@
+/*
+ * ==============================================
+ * File:        Loopback.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 17 October 2026
+ * Version:     1.0
+ * Description: Loopback check of rate matching and de-rate
+ *              matching. The rate-matched bits go through a
+ *              noise-free channel as LLRs, and the soft values
+ *              that come back must have the sign of the input
+ *              bits, HARQ retransmissions with another rv
+ *              combined in.
+ * ==============================================
+ */
+
+#include "Loopback.h"
+#include "rmKernel.h"
+#include <algorithm>
+#include <iostream>
+
+void loopbackChannel::sendBlock() {
+    for (size_t i = 0; i < llrs.size(); i += LLR_PER_BEAT) {
+        llrBeat beat;
+        beat.data = sc_lv<128>(0);
+        for (int j = 0; j < LLR_PER_BEAT && i + j < llrs.size(); ++j) {
+            int hi = 127 - 8 * j;
+            beat.data.range(hi, hi - 7) = (uint8_t)llrs[i + j];
+        }
+        beat.last = (i + LLR_PER_BEAT >= llrs.size());
+        beats.push_back(beat);
+    }
+    llrs.clear();
+}
+
+void loopbackChannel::channelfunction() {
+
+    // Initialize output signals
+    din_ready.write(false);
+    dout_valid.write(false);
+    dout_last.write(false);
+    config_valid.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            din_ready.write(false);
+            dout_valid.write(false);
+            dout_last.write(false);
+            config_valid.write(false);
+            configs.clear();
+            forward.clear();
+            beats.clear();
+            llrs.clear();
+            cbIndex = 0;
+            continue; // Move to next cycle
+        }
+
+        // Handshakes of the previous cycle
+        if (config_valid.read() && config_ready.read()) {
+            forward.pop_front();
+        }
+        if (dout_valid.read() && dout_ready.read()) {
+            beats.pop_front();
+        }
+        if (rm_config_valid.read() && rm_config_ready.read()) {
+            ratematchingConfig cfg = toRatematchingConfig(rm_config_data.read());
+            configs.push_back(cfg);
+            forward.push_back(cfg);
+        }
+
+        // The code blocks of a transport block are concatenated, the rest of its last beat is padding
+        if (din_valid.read() && din_ready.read()) {
+            const ratematchingConfig& cfg = configs.front();
+            int C = cfg.codeBlocks();
+            int G = cfg.tbOutputBits();
+            uint64_t words[sizePort / 64];
+            lvToWords(din_data.read(), words);
+            for (int i = 0; i < sizePort && cbIndex < C; ++i) {
+                int bit = (int)((words[i >> 6] >> (63 - (i & 63))) & 1);
+                llrs.push_back((int8_t)(bit ? -LOOPBACK_LLR : LOOPBACK_LLR));
+                if ((int)llrs.size() == rmBlockE(G, C, cbIndex, cfg.nlayers, cfg.Qm)) {
+                    sendBlock();
+                    ++cbIndex;
+                }
+            }
+            if (din_last.read()) {
+                configs.pop_front();
+                llrs.clear();
+                cbIndex = 0;
+            }
+        }
+
+        din_ready.write(!configs.empty() && beats.size() < 2 * sizePort / LLR_PER_BEAT);
+        if (!forward.empty()) {
+            config_data.write(toConfigData(forward.front()));
+            config_valid.write(true);
+        }
+        else {
+            config_valid.write(false);
+        }
+        if (!beats.empty()) {
+            dout_data.write(beats.front().data);
+            dout_valid.write(true);
+            dout_last.write(beats.front().last);
+        }
+        else {
+            dout_valid.write(false);
+            dout_last.write(false);
+        }
+    }
+}
+
+void loopbackChecker::takeInput(const ratematchingConfig& cfg, const std::vector<uint64_t>& words) {
+    int N = cfg.inlen;
+    int C = cfg.codeBlocks();
+    size_t blockWords = (size_t)(N + sizePort - 1) / sizePort * (sizePort / 64);
+    for (int r = 0; r < C; ++r) {
+        expectedBlock block;
+        block.cfg = cfg;
+        block.r = r;
+        block.bits.resize(N);
+        const uint64_t* w = words.data() + r * blockWords;
+        for (int i = 0; i < N; ++i) {
+            block.bits[i] = (uint8_t)((w[i >> 6] >> (63 - (i & 63))) & 1);
+        }
+        expected.push_back(std::move(block));
+    }
+}
+
+void loopbackChecker::checkBlock() {
+    const expectedBlock& block = expected.front();
+    const ratematchingConfig& cfg = block.cfg;
+    int C = cfg.codeBlocks();
+    int G = cfg.tbOutputBits();
+    int E = rmBlockE(G, C, block.r, cfg.nlayers, cfg.Qm);
+    const rmPlan& plan = planCache.get(cfg.inlen, cfg.rv, cfg.Nref, E, cfg.Qm, cfg.F);
+
+    // Whole beats of 8 soft values, the padding is 0
+    if ((int)soft.size() != (plan.Ncb + SOFT_PER_BEAT - 1) / SOFT_PER_BEAT * SOFT_PER_BEAT) {
+        if (lengthErrors++ == 0) {
+            std::cerr << "Loopback: " << soft.size() << " soft values for code block " << block.r << " of "
+                      << C << ", Ncb " << plan.Ncb << ", at " << sc_time_stamp() << std::endl;
+        }
+    }
+    else {
+        int errors = 0;
+        for (int k = 0; k < plan.Ncb; ++k) {
+            if (soft[k] != 0) {
+                ++softChecked;
+                errors += ((soft[k] > 0) != (block.bits[k] == 0)) ? 1 : 0;
+            }
+        }
+        int unset = 0;
+        for (const rmRun& run : plan.runs) {
+            unset += (int)std::count(soft.begin() + run.pos, soft.begin() + run.pos + run.len, (int16_t)0);
+        }
+        if ((errors != 0 || unset != 0) && signErrors + unsetErrors == 0) {
+            std::cerr << "Loopback: Code block " << block.r << " of " << C << " of HARQ process " << cfg.harqId
+                      << ", rv " << cfg.rv << ": " << errors << " soft values of the wrong sign, " << unset
+                      << " selected ones at 0, at " << sc_time_stamp() << std::endl;
+        }
+        signErrors += errors;
+        unsetErrors += unset;
+    }
+
+    ++blocksChecked;
+    combinedBlocks += cfg.retransmit ? 1 : 0;
+    if (block.r == C - 1) {
+        ++tbChecked;
+    }
+    expected.pop_front();
+    soft.clear();
+}
+
+void loopbackChecker::checkerfunction() {
+
+    soft_ready.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            soft_ready.write(false);
+            configs.clear();
+            hits.clear();
+            inWords.clear();
+            harqInput.clear();
+            expected.clear();
+            soft.clear();
+            continue; // Move to next cycle
+        }
+
+        if (config_valid.read() && config_ready.read()) {
+            configs.push_back(toRatematchingConfig(config_data.read()));
+        }
+        if (harq_valid.read() && harq_ready.read()) {
+            hits.push_back(harq_hit.read());
+        }
+        if (din_valid.read() && din_ready.read()) {
+            uint64_t words[sizePort / 64];
+            lvToWords(din_data.read(), words);
+            inWords.insert(inWords.end(), words, words + sizePort / 64);
+        }
+
+        // Transport blocks whose input is complete, or known to come from the HARQ store
+        while (!configs.empty()) {
+            const ratematchingConfig& cfg = configs.front();
+            int C = cfg.codeBlocks();
+            size_t words = (size_t)C * (((int)cfg.inlen + sizePort - 1) / sizePort) * (sizePort / 64);
+            std::vector<uint64_t>& input = harqInput[cfg.harqId];
+            if (cfg.retransmit && hits.empty()) {
+                break;
+            }
+            if (cfg.retransmit && hits.front()) {
+                if (input.size() != words) {
+                    std::cerr << "Loopback: No input of HARQ process " << cfg.harqId << std::endl;
+                    input.assign(words, 0);
+                }
+                ++storedTbs;
+            }
+            else {
+                if (inWords.size() < words) {
+                    break;
+                }
+                input.assign(inWords.begin(), inWords.begin() + words);
+                inWords.erase(inWords.begin(), inWords.begin() + words);
+            }
+            takeInput(cfg, input);
+            if (cfg.retransmit) {
+                hits.pop_front();
+            }
+            configs.pop_front();
+        }
+
+        if (soft_valid.read() && soft_ready.read()) {
+            sc_lv<128> data = soft_data.read();
+            for (int i = 0; i < SOFT_PER_BEAT; ++i) {
+                int hi = 127 - 16 * i;
+                soft.push_back((int16_t)data.range(hi, hi - 15).to_uint());
+            }
+            if (soft_last.read()) {
+                if (expected.empty()) {
+                    ++lengthErrors;
+                    soft.clear();
+                }
+                else {
+                    checkBlock();
+                }
+                if (tbChecked == numTransportBlocks) {
+                    sc_stop();
+                }
+            }
+        }
+        soft_ready.write(true);
+    }
+}
+
+bool loopbackChecker::passed() const {
+    return tbChecked == numTransportBlocks && signErrors == 0 && unsetErrors == 0 && lengthErrors == 0;
+}
+
+void loopbackChecker::report() const {
+    std::cout << "Loopback: " << tbChecked << " of " << numTransportBlocks << " transport blocks, "
+              << blocksChecked << " code blocks (" << combinedBlocks << " retransmitted, " << storedTbs
+              << " transport blocks from the HARQ store), " << softChecked << " soft values checked, "
+              << signErrors << " of the wrong sign, " << unsetErrors << " selected ones at 0";
+    if (lengthErrors != 0) {
+        std::cout << ", " << lengthErrors << " code blocks of the wrong length";
+    }
+    std::cout << (passed() ? " - PASS" : " - FAIL") << std::endl;
+}
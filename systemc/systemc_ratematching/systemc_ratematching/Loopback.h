@@ -0,0 +1,148 @@
+// Loopback.h
+
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <systemc.h>
+#include <deque>
+#include <map>
+#include <vector>
+#include "ratematching.h"
+#include "Deratematching.h"
+
+// Magnitude of the LLRs the loopback channel makes of the rate-matched bits
+const int LOOPBACK_LLR = 8;
+
+// Noise-free channel from ratematching<sizePort, 1> to deratematching: each
+// rate-matched bit becomes an LLR, +LOOPBACK_LLR for 0 and -LOOPBACK_LLR for 1,
+// sent as the E LLRs of its code block with din_last on the last beat. The
+// configurations are taken from the ratematching configuration bus as the DUT
+// accepts them, and forwarded to deratematching.
+SC_MODULE(loopbackChannel) {
+public:
+    // Ports
+    sc_in<bool>                 clk;            // Clock
+    sc_in<bool>                 rst;            // Reset
+
+    // Configuration bus of ratematching, observed only
+    sc_in<sc_lv<CFG_WIDTH>>     rm_config_data;
+    sc_in<bool>                 rm_config_valid;
+    sc_in<bool>                 rm_config_ready;
+
+    sc_in<sc_lv<sizePort>>      din_data;       // Rate-matched bits from ratematching
+    sc_in<bool>                 din_valid;
+    sc_in<bool>                 din_last;       // Last beat of a transport block
+    sc_out<bool>                din_ready;
+
+    sc_out<sc_lv<128>>          dout_data;      // 16 LLRs to deratematching
+    sc_out<bool>                dout_valid;
+    sc_out<bool>                dout_last;      // Last beat of a code block
+    sc_in<bool>                 dout_ready;
+
+    sc_out<sc_lv<CFG_WIDTH>>    config_data;    // Configurations to deratematching
+    sc_out<bool>                config_valid;
+    sc_in<bool>                 config_ready;
+
+    SC_HAS_PROCESS(loopbackChannel);
+    explicit loopbackChannel(sc_module_name name) : sc_module(name) {
+        SC_THREAD(channelfunction);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
+    }
+
+private:
+    struct llrBeat {
+        sc_lv<128> data;
+        bool last;
+    };
+
+    std::deque<ratematchingConfig> configs;     // Transport blocks whose bits are awaited
+    std::deque<ratematchingConfig> forward;     // Configurations not yet taken by deratematching
+    std::deque<llrBeat> beats;                  // LLR beats not yet taken by deratematching
+    std::vector<int8_t> llrs;                   // LLRs of the code block being received
+    int cbIndex = 0;                            // Index r of that code block
+
+    // Cut the LLRs of a complete code block into beats
+    void sendBlock();
+
+    void channelfunction();
+};
+
+// Checks the loopback: each soft value deratematching sends must have the sign
+// of the bit ratematching was given at the same circular buffer position, + for
+// 0 and - for 1, wherever it is not 0, and every position the bit selection of
+// the block reads must be set. The input bits are taken from the ratematching
+// din and HARQ status handshakes; a retransmission the DUT takes from its HARQ
+// store has the input of the last transport block of its process.
+SC_MODULE(loopbackChecker) {
+public:
+    // Ports
+    sc_in<bool>                 clk;            // Clock
+    sc_in<bool>                 rst;            // Reset
+
+    // Handshakes of ratematching, observed only
+    sc_in<sc_lv<CFG_WIDTH>>     config_data;
+    sc_in<bool>                 config_valid;
+    sc_in<bool>                 config_ready;
+    sc_in<sc_lv<sizePort>>      din_data;
+    sc_in<bool>                 din_valid;
+    sc_in<bool>                 din_ready;
+    sc_in<bool>                 harq_valid;
+    sc_in<bool>                 harq_hit;
+    sc_in<bool>                 harq_ready;
+
+    sc_in<sc_lv<128>>           soft_data;      // 8 soft values from deratematching
+    sc_in<bool>                 soft_valid;
+    sc_in<bool>                 soft_last;      // Last beat of a code block
+    sc_out<bool>                soft_ready;
+
+    SC_HAS_PROCESS(loopbackChecker);
+    loopbackChecker(sc_module_name name, long long transportBlocks)
+        : sc_module(name), numTransportBlocks(transportBlocks) {
+        SC_THREAD(checkerfunction);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
+    }
+
+    // Every transport block came back with no error
+    bool passed() const;
+
+    // Print the code blocks and soft values checked and the errors found
+    void report() const;
+
+private:
+    // Input of one code block and the configuration of its transport block
+    struct expectedBlock {
+        ratematchingConfig cfg;
+        int r;
+        std::vector<uint8_t> bits;
+    };
+
+    const long long numTransportBlocks;
+    std::deque<ratematchingConfig> configs;     // Waiting for their input
+    std::deque<bool> hits;                      // harq_hit of the retransmissions, in order
+    std::vector<uint64_t> inWords;              // din beats not yet given to a transport block
+    std::map<int, std::vector<uint64_t>> harqInput;  // Last input of each HARQ process
+    std::deque<expectedBlock> expected;         // Waiting for their soft values
+    std::vector<int16_t> soft;                  // Soft values of the block being received
+    rmPlanCache planCache;
+
+    long long tbChecked = 0;
+    long long blocksChecked = 0;
+    long long combinedBlocks = 0;               // Blocks of retransmissions, combined with an earlier rv
+    long long storedTbs = 0;                    // Retransmissions taken from the HARQ store
+    long long softChecked = 0;                  // Soft values not 0
+    long long signErrors = 0;
+    long long unsetErrors = 0;                  // Selected positions left at 0
+    long long lengthErrors = 0;                 // Blocks of the wrong number of soft values
+
+    // Queue the code blocks of a transport block with its input, C blocks of whole beats
+    void takeInput(const ratematchingConfig& cfg, const std::vector<uint64_t>& words);
+
+    // Compare the soft values of the oldest expected block
+    void checkBlock();
+
+    void checkerfunction();
+};
+
+#endif // LOOPBACK_H
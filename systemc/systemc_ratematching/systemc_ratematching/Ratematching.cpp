@@ -29,255 +29,469 @@
 #include <fstream>
 #include <iostream>
 #include "myLibrary.h"
-
- /*************** Define constants**************/
-const std::vector<int> ZcVec = {
-    2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
-    18, 20, 22, 24, 26, 28, 30, 32, 36, 40, 44, 48, 52,
-    56, 60, 64, 72, 80, 88, 96, 104, 112, 120, 128, 144,
-    160, 176, 192, 208, 224, 240, 256, 288, 320, 352, 384
-};
+#include "rmKernel.h"
+#include "rmPlan.h"
+#include "rmStats.h"
+#include "Log.h"
 
 /*************** Define functions**************/
-void ratematching::ratematchingfunction() {
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::ingestfunction() {
 
-    ratematchingConfig config;
+    ratematchingConfig config;  // Configuration of the transport block being received
+    bool active = false;        // A transport block is bound to config
+    int fill = 0;        // Ping-pong buffer being filled
+    int cbIndex = 0;     // Index r of the next code block in the transport block
+    bool replay = false; // The code blocks of the transport block come from the HARQ store
+    long long cycle = 0;
 
     // Initialize output signals
     din_ready.write(false);
-    dout_valid.write(false);
-    dout_last.write(false);
     config_ready.write(false);
+    harq_valid.write(false);
+    harq_hit.write(false);
 
     while (true) {
         wait(); // Wait for clock edge
+        ++cycle;
 
         // Reset condition
         if (rst.read()) {
-
-            dout_valid.write(false);
-            dout_last.write(false);
             din_ready.write(false);
-            // Clear the FIFO
-            while (!dataFIFO.empty()) {
-                dataFIFO.pop();
+            config_ready.write(false);
+            harq_valid.write(false);
+            harq_hit.write(false);
+            harqStatus = std::queue<bool>();
+            for (int b = 0; b < 2; ++b) {
+                cbBuffer[b].clear();
+                cbFillPhase[b].write(false);
+                cbStartPhase[b].write(false);
+                cbBeats[b].write(0);
             }
-            config_ready.write(false); 
+            while (!cfgFifo.empty()) {
+                cfgFifo.pop();
+            }
+            harqStore.clear();
+            active = false;
+            replay = false;
+            fill = 0;
+            cbIndex = 0;
             continue; // Move to next cycle
         }
 
-        // Configuration input handling
-        if (config_valid.read()) {
-            sc_lv<CFG_WIDTH> iConfigData = config_data.read();
-            // Parse the configuration data
-            config.inlen = iConfigData.range(15, 0).to_uint();
-            config.outlen = iConfigData.range(31, 16).to_uint();
-            config.rv = iConfigData.range(33, 32).to_uint();
-            config.nlayers = iConfigData.range(36, 34).to_uint();
-            config.Qm = iConfigData.range(40, 37).to_uint();
-            config.Nref = iConfigData.range(46, 41).to_uint();
-            config_ready.write(true); // Indicate configuration is processed
-            std::cout << "RateMatching: Configuration received and processed." << std::endl;
-            wait(); // Wait for next cycle to continue processing
-            continue;
-        }
-        else {
-            config_ready.write(false); // No config, continue waiting
-        }
+        cfgStats.sample(config_valid.read(), config_ready.read());
+        inStats.sample(din_valid.read(), din_ready.read());
 
-        // Always set din_ready based on FIFO size
-        if (dataFIFO.size() < (MAX_FIFO_SIZE / sizePort)) {
-            din_ready.write(true);  // FIFO is not full, allowing new data to be received
+        // Configuration input handling, taken on the edge where valid and ready are both high
+        if (config_valid.read() && config_ready.read()) {
+            cfgFifo.push(toRatematchingConfig(config_data.read()));
+            RM_LOG(SC_HIGH, name(), "Configuration received and queued");
         }
-        else {
-            din_ready.write(false); // FIFO full, not receiving new data
-        }
-
-        while (!din_valid.read()) {
-            wait();
+        if (harq_valid.read() && harq_ready.read()) {
+            harqStatus.pop();
         }
 
+        // Data input handling
         if (din_valid.read() && din_ready.read()) {
-            sc_lv<128> input_data = din_data.read();
-            dataFIFO.push(input_data); // Add data to the FIFO
-            //std::cout << "index Input" << dataFIFO.size() << std::endl;
+            uint64_t input_data[IN_WORDS];
+            lvToWords(din_data.read(), input_data);
+            cbBuffer[fill].pushBeat(input_data);
+            cbBeats[fill].write(cbBuffer[fill].beats());
             //std::cout << "RateMatching: Data received: " << input_data << std::endl;
-            din_ready.write(true); // Ready to receive more data	
 
+            // The configuration of the block is known from its first beat on (cut-through)
+            if (cbBuffer[fill].beats() == 1) {
+                cbStartCycle[fill] = cycle;
+                cbConfig[fill] = config;
+                cbBlockIndex[fill] = cbIndex;
+                toggle(cbStartPhase[fill]);
+            }
+
+            // din_last marks the end of each code block: hand the buffer over to rate matching
+            if (din_last.read() || cbBuffer[fill].full()) {
+                int C = config.codeBlocks();
+                harqStore.put(config.harqId, cbIndex, cbBuffer[fill].data());
+                cbIndex = (cbIndex + 1 < C) ? cbIndex + 1 : 0;
+                toggle(cbFillPhase[fill]);
+                fill ^= 1;
+
+                // The transport block is complete, the next one needs a new configuration
+                if (cbIndex == 0) {
+                    active = false;
+                }
+            }
         }
-        else {
-            din_ready.write(false); // Not ready to receive data
+
+        // Bind the next queued configuration as soon as the previous transport block ends
+        if (!active && !cfgFifo.empty()) {
+            config = cfgFifo.front();
+            cfgFifo.pop();
+            active = true;
+            cbIndex = 0;
+
+            // A retransmission found in the HARQ store is not received again,
+            // any other transport block is stored as it arrives
+            int C = config.codeBlocks();
+            replay = config.retransmit && harqStore.lookup(config.harqId, config.inlen, C);
+            if (!replay) {
+                harqStore.begin(config.harqId, config.inlen, C, IN_WIDTH);
+            }
+            if (config.retransmit) {
+                harqStatus.push(replay);
+            }
         }
 
-        // Begin rate matching if enough data is available in FIFO
-        if (dataFIFO.size() == (MAX_FIFO_SIZE / sizePort)) {
+        // Size the free buffer for the next code block
+        bool bufferFree = !cbFull(fill);
+        if (active && bufferFree && cbBuffer[fill].empty()) {
+            cbBuffer[fill].configure(config.inlen, IN_WIDTH);
+        }
 
-            std::cout << "RateMatching: Starting rate matching process." << std::endl;
-            din_ready.write(false);
+        // A stored code block fills the free buffer in one cycle, as bit selection
+        // would read the stored circular buffer in place
+        if (active && replay && bufferFree) {
+            int C = config.codeBlocks();
+            cbBuffer[fill].load(harqStore.block(config.harqId, cbIndex));
+            cbBeats[fill].write(cbBuffer[fill].beats());
+            cbStartCycle[fill] = cycle;
+            cbConfig[fill] = config;
+            cbBlockIndex[fill] = cbIndex;
+            toggle(cbStartPhase[fill]);
+            toggle(cbFillPhase[fill]);
+            fill ^= 1;
+            ++harqBlocks;
+            cbIndex = (cbIndex + 1 < C) ? cbIndex + 1 : 0;
+            if (cbIndex == 0) {
+                active = false;
+                replay = false;
+            }
+        }
+
+        cfgOccupancy.sample(cfgFifo.size());
+        config_ready.write((int)cfgFifo.size() < cfgFifoDepth);
+        din_ready.write(active && !replay && bufferFree && !cbBuffer[fill].full());
+        harq_valid.write(!harqStatus.empty());
+        harq_hit.write(!harqStatus.empty() && harqStatus.front());
+    }
+}
 
-            // Read configuration values
+ratematchingConfig toRatematchingConfig(const sc_lv<CFG_WIDTH>& data) {
+    ratematchingConfig config;
+    config.inlen = data.range(15, 0).to_uint();
+    config.outlen = data.range(31, 16).to_uint();
+    config.rv = data.range(33, 32).to_uint();
+    config.nlayers = data.range(36, 34).to_uint();
+    config.Qm = data.range(40, 37).to_uint();
+    config.Nref = data.range(46, 41).to_uint();
+    config.C = data.range(54, 47).to_uint();
+    config.G = data.range(78, 55).to_uint();
+    config.F = data.range(92, 79).to_uint();
+    config.harqId = data.range(96, 93).to_uint();
+    config.retransmit = (data.range(97, 97).to_uint() != 0);
+    return config;
+}
+
+sc_lv<CFG_WIDTH> toConfigData(const ratematchingConfig& config) {
+    sc_lv<CFG_WIDTH> data;
+    data.range(15, 0) = config.inlen;
+    data.range(31, 16) = config.outlen;
+    data.range(33, 32) = config.rv;
+    data.range(36, 34) = config.nlayers;
+    data.range(40, 37) = config.Qm;
+    data.range(46, 41) = config.Nref;
+    data.range(54, 47) = config.C;
+    data.range(78, 55) = config.G;
+    data.range(92, 79) = config.F;
+    data.range(96, 93) = config.harqId;
+    data.range(97, 97) = config.retransmit ? 1 : 0;
+    return data;
+}
+
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::ratematchingfunction() {
+
+    int cur = 0;     // Ping-pong code block buffer to process next
+    int outB = 0;    // Ping-pong output buffer to fill next
+    const rmPlan* plan = nullptr;  // Plan of code block cur once it is started, its output goes to outB
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            cur = 0;
+            outB = 0;
+            plan = nullptr;
+            for (int b = 0; b < 2; ++b) {
+                cbFreePhase[b].write(false);
+                outFillPhase[b].write(false);
+                outReady[b].write(0);
+            }
+            tbCarryBits = 0;
+            continue; // Move to next cycle
+        }
+
+        // Begin rate matching once a code block is complete, or has started in
+        // cut-through mode, and an output buffer is free
+        if (plan == nullptr && (cbFull(cur) || (cutThrough && cbStarted(cur))) && !outFull(outB)) {
+
+            // Read configuration values of this code block
+            const ratematchingConfig& config = cbConfig[cur];
+            int cbIndex = cbBlockIndex[cur];
             int inlen = config.inlen;
             int outlen = config.outlen;
             int rv = config.rv;
             int nlayers = config.nlayers;
             int Qm = config.Qm;
             int Nref = config.Nref;
-
-            std::cout << "Config Loaded: " << std::endl;
-            std::cout << "  Input Length (inlen): " << inlen << std::endl;
-            std::cout << "  Output Length (outlen): " << outlen << std::endl;
-            std::cout << "  Redundancy Version (rv): " << rv << std::endl;
-            std::cout << "  Number of Layers (nlayers): " << nlayers << std::endl;
-            std::cout << "  Modulation Type (Qm): " << Qm << std::endl;
-            std::cout << "  Nref: " << Nref << std::endl;
-
-            // Concatenate all FIFO data into one data stream for processing
-            sc_lv<MAX_FIFO_SIZE> concatenatedData;
-            int bitIndex = 0;
-            while (!dataFIFO.empty()) {
-                sc_lv<128> data = dataFIFO.front();
-                dataFIFO.pop();
-
-                // Insert 128-bit data into concatenatedData
-                for (int i = 0; i < 128; ++i) {
-                    concatenatedData[bitIndex + i] = data[127 - i];
-                }
-                bitIndex += 128; // Move the index for the next chunk
+            int F = config.F;
+            int C = config.codeBlocks();
+            int G = config.tbOutputBits();
+
+            RM_LOG(SC_FULL, name(), "Starting rate matching of code block " << cbIndex + 1 << " of " << C
+                   << ": inlen " << inlen << ", outlen " << outlen << ", rv " << rv << ", nlayers " << nlayers
+                   << ", Qm " << Qm << ", Nref " << Nref << ", filler bits " << F << ", "
+                   << cbBeats[cur].read() * IN_WIDTH << " bits buffered");
+
+            // Output length of this code block out of the C scheduled blocks
+            int E = rmBlockE(G, C, cbIndex, nlayers, Qm);
+
+            // k0, Ncb and the bit selection runs are computed once per distinct configuration
+            plan = &planCache.get(inlen, rv, Nref, E, Qm, F);
+            reserveBuffers(config);
+
+            // Code block concatenation: the block goes behind the bits left over from the previous block;
+            // only whole beats are sent until the last block, which is zero-padded
+            if (cbIndex == 0) {
+                tbCarryBits = 0;
+            }
+            ratematchingOutput& out = outBuffer[outB];
+            int totalBits = tbCarryBits + E;
+            out.last = (cbIndex >= C - 1);
+            out.beats = out.last ? (totalBits + OUT_WIDTH - 1) / OUT_WIDTH : totalBits / OUT_WIDTH;
+            out.ready = 0;
+            outReady[outB].write(0);
+            out.startCycle = cbStartCycle[cur];
+
+            // Cut-through pays off when the first output beat needs less than the whole block,
+            // otherwise no beat is ready before the block is complete
+            if (!cbFull(cur) && rmRequiredBits(*plan, OUT_WIDTH - tbCarryBits) < cbBuffer[cur].length()) {
+                ++cutThroughBlocks;
+            }
+            else {
+                ++storeForwardBlocks;
             }
 
-            std::cout << "RateMatching: Concatenated data size: " << bitIndex << " bits." << std::endl;
+            // Hand the output buffer over to egress, which sends the beats as they become ready
+            toggle(outFillPhase[outB]);
+        }
 
-            // Convert concatenated data to vector of bits for rate matching
-            std::vector<int> concatenatedDataVector(bitIndex);
-            for (int i = 0; i < bitIndex; ++i) {
-                char bit = concatenatedData[i].to_char();
-                concatenatedDataVector[i] = (bit == '1') ? 1 : 0;
-            }
+        if (plan != nullptr) {
+            ratematchingOutput& out = outBuffer[outB];
+            bool complete = cbFull(cur);
 
-            // Perform the rate matching process using the updated logic
-            std::vector<int> input(concatenatedDataVector.begin(), concatenatedDataVector.begin() + inlen);
-            // Get code block soft buffer size
-            int minValue = (inlen < Nref) ? inlen : Nref;
-            int Ncb = (Nref != 0) ? minValue : inlen;
-
-            // Determine base graph number from N
-            int bgn, ncwnodes, Zc;
-            bool found = 0;
-            for (size_t i = 0; i < ZcVec.size(); ++i) {
-                if (inlen == ZcVec[i] * 66) {
-                    found = 1;
-                }
+            // Output beats whose input bits have all arrived
+            long long received = (long long)cbBeats[cur].read() * IN_WIDTH;
+            int ready = out.ready;
+            while (ready < out.beats &&
+                   (complete || rmRequiredBits(*plan, (ready + 1) * OUT_WIDTH - tbCarryBits) <= received)) {
+                ++ready;
             }
 
-            if (found) {
-                bgn = 1;
-                ncwnodes = 66;
-            }
-            else {
-                bgn = 2;
-                ncwnodes = 50;
+            // Perform rate matching (bit selection and bit interleaving) on what is there
+            if (ready > out.ready || complete) {
+                assembleOutput(cur, *plan, out);
+                out.ready = ready;
+                outReady[outB].write(ready);
             }
-            Zc = inlen / ncwnodes;
 
-            // Get starting position in circular buffer
-            int k0;
-            if (bgn == 1) {
-                if (rv == 0) {
-                    k0 = 0;
-                }
-                else if (rv == 1) {
-                    //k0 = myFloor(17.0 * Ncb / inlen) * Zc;
-                    k0 = static_cast<int>(std::floor(17.0 * Ncb / inlen) * Zc);
-                }
-                else if (rv == 2) {
-                    //k0 = myFloor(33.0 * Ncb / inlen) * Zc;
-                    k0 = static_cast<int>(std::floor(33.0 * Ncb / inlen) * Zc);
-                }
-                else {
-                    //k0 = myFloor(56.0 * Ncb / inlen) * Zc;
-                    k0 = static_cast<int>(std::floor(56.0 * Ncb / inlen) * Zc);
-                }
-            }
-            else {
-                if (rv == 0) {
-                    k0 = 0;
-                }
-                else if (rv == 1) {
-                    //k0 = myFloor(13.0 * Ncb / inlen) * Zc;
-                    k0 = static_cast<int>(std::floor(13.0 * Ncb / inlen) * Zc);
-                }
-                else if (rv == 2) {
-                    //k0 = myFloor(25.0 * Ncb / inlen) * Zc;
-                    k0 = static_cast<int>(std::floor(25.0 * Ncb / inlen) * Zc);
-                }
-                else {
-                    //k0 = myFloor(43.0 * Ncb / inlen) * Zc;
-                    k0 = static_cast<int>(std::floor(43.0 * Ncb / inlen) * Zc);
-                }
+            if (complete) {
+                // Keep the remainder for the next code block
+                int totalBits = tbCarryBits + plan->E;
+                tbCarryBits = out.last ? 0 : totalBits - out.beats * OUT_WIDTH;
+                std::fill(tbCarry, tbCarry + OUT_WORDS, 0);
+                rmCopyBits(tbCarry, 0, out.words.data(), out.beats * OUT_WIDTH, tbCarryBits);
+
+                // The code block buffer goes back to ingest
+                cbBuffer[cur].clear();
+                toggle(cbFreePhase[cur]);
+                cur ^= 1;
+                outB ^= 1;
+                plan = nullptr;
             }
+        }
+    }
+}
 
-            /*int E = (1 - (outlen / (nlayers * Qm)) - 1) >= 0 ? nlayers * Qm * myFloor(static_cast<double>(outlen) / (nlayers * Qm))
-                : nlayers * Qm * myCeil(static_cast<double>(outlen) / (nlayers * Qm));*/
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::assembleOutput(int b, const rmPlan& plan, ratematchingOutput& out) {
+    rmRunPlan(plan, cbBuffer[b].data(), selectedBits.data(), rateMatchedData.data());
 
-            int E;
-            if ((1 - (outlen / (nlayers * Qm)) - 1) >= 0)
-            {
-                E = nlayers * Qm * static_cast<int>(std::floor(static_cast<double>(outlen) / (nlayers * Qm)));
-            }
-            else {
-                E = nlayers * Qm * static_cast<int>(std::ceil(static_cast<double>(outlen) / (nlayers * Qm)));
-            }
+    int totalBits = tbCarryBits + plan.E;
+    int words = OUT_WORDS * ((totalBits + OUT_WIDTH - 1) / OUT_WIDTH);
+    std::fill(out.words.begin(), out.words.begin() + words, 0);
+    rmCopyBits(out.words.data(), 0, tbCarry, 0, tbCarryBits);
+    rmCopyBits(out.words.data(), tbCarryBits, rateMatchedData.data(), 0, plan.E);
+}
 
-            // Perform rate matching
-            std::vector<int> e(E, 0);
-            int k = 0;
-            int j = 0;
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::egressfunction() {
 
-            while (k < E) {
-                if (input[(k0 + j) % Ncb] != -1) {
-                    e[k] = input[(k0 + j) % Ncb];
-                    ++k;
-                }
-                ++j;
-            }
+    int b = 0;       // Ping-pong output buffer being sent
+    int beat = 0;    // Next beat of that buffer
+    long long cycle = 0;
 
-            // Bit Interleaving
-            int rows = E / Qm;
-            std::vector<int> e_reshaped(E);
-            for (int i = 0; i < rows; ++i) {
-                for (int j = 0; j < Qm; ++j) {
-                    e_reshaped[i * Qm + j] = e[j * rows + i];
-                }
+    // Initialize output signals
+    dout_valid.write(false);
+    dout_last.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+        ++cycle;
+
+        // Reset condition
+        if (rst.read()) {
+            dout_valid.write(false);
+            dout_last.write(false);
+            while (!outFifo.empty()) {
+                outFifo.pop();
             }
+            outFreePhase[0].write(false);
+            outFreePhase[1].write(false);
+            b = 0;
+            beat = 0;
+            continue; // Move to next cycle
+        }
 
-            std::vector<int> rateMatchedData = e_reshaped; // output of rate matching
-            std::cout << std::endl;
-            dout_valid.write(true); // Signal valid output
-            int dRows = rateMatchedData.size();
+        // The head beat is taken on the edge where dout_valid and dout_ready are both high
+        outStats.sample(dout_valid.read(), dout_ready.read());
+        if (dout_valid.read() && dout_ready.read()) {
+            const ratematchingBeat<OUT_WORDS>& sent = outFifo.front();
+            if (sent.last) {
+                RM_LOG(SC_HIGH, name(), "Last output data of the transport block transmitted");
+            }
+            if (sent.blockStart) {
+                firstOutLatency.add(cycle - sent.startCycle);
+            }
+            if (sent.blockEnd) {
+                lastOutLatency.add(cycle - sent.startCycle);
+            }
+            outFifo.pop();
+        }
 
-            // Transmit the rate matched data, with the last chunk condition
-            for (int start = 0; start < dRows; start += sizePort) {
-                sc_lv<128> sinkdata;
-                for (int i = 0; i < sizePort; ++i) {
-                    sinkdata[sizePort - 1 - i] = (start + i < dRows) ? rateMatchedData[start + i] : 0; // Zero-padding
-                }
+        // Move one dout word (BEATS beats) per cycle from the output buffer into the FIFO
+        if (outFull(b) && beat < outReady[b].read() && (int)outFifo.size() < outFifoDepth) {
+            const ratematchingOutput& out = outBuffer[b];
+            ratematchingBeat<OUT_WORDS> next;
+            std::copy(out.words.begin() + OUT_WORDS * beat, out.words.begin() + OUT_WORDS * (beat + 1), next.w);
+            next.last = out.last && beat == out.beats - 1;
+            next.blockStart = (beat == 0);
+            next.blockEnd = (beat == out.beats - 1);
+            next.startCycle = out.startCycle;
+            outFifo.push(next);
+            ++beat;
+        }
 
-                dout_data.write(sinkdata); // Write to output
+        // Move on to the other buffer once this one is in the FIFO, without a bubble
+        if (outFull(b) && beat >= outBuffer[b].beats) {
+            toggle(outFreePhase[b]);
+            b ^= 1;
+            beat = 0;
+        }
 
-                // Signal dout_last if this is the last output chunk
-                if (start + sizePort >= dRows) {
-                    dout_last.write(true); // Indicate last data
-                    std::cout << "RateMatching: Last output data transmitted." << std::endl;
-                }
+        outOccupancy.sample(outFifo.size());
 
-                wait(); // Wait for the next clock cycle
-            }
+        // Present the head of the FIFO until the sink takes it
+        if (!outFifo.empty()) {
+            const ratematchingBeat<OUT_WORDS>& head = outFifo.front();
+            sc_lv<OUT_WIDTH> sinkdata;
+            wordsToLv(head.w, sinkdata);
 
-            // Once the final output is sent, reset valid and last signals
+            dout_data.write(sinkdata);  // Write to output
+            dout_valid.write(true);     // Signal valid output
+            dout_last.write(head.last); // Signal dout_last on the last output chunk of the transport block
+        }
+        else {
             dout_valid.write(false);
             dout_last.write(false);
-            
         }
-
     }
-}
\ No newline at end of file
+}
+
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::reserveBuffers(const ratematchingConfig& cfg) {
+    int C = cfg.codeBlocks();
+    int G = cfg.tbOutputBits();
+
+    // The last code block gets the largest (rounded up) share of G
+    int maxE = rmBlockE(G, C, C - 1, cfg.nlayers, cfg.Qm);
+    size_t words = OUT_WORDS * ((maxE + OUT_WIDTH - 1) / OUT_WIDTH);
+    if (selectedBits.size() < words) {
+        selectedBits.resize(words);
+        rateMatchedData.resize(words);
+        outBuffer[0].words.resize(words + OUT_WORDS); // plus the carry of the previous block
+        outBuffer[1].words.resize(words + OUT_WORDS);
+    }
+}
+
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::reportThroughput() const {
+    // Steady state: beats over the cycles between the first and the last beat
+    std::cout << "RateMatching: " << IN_WIDTH << "-bit din, " << BEATS << " x " << WIDTH << "-bit dout" << std::endl;
+    std::cout << "RateMatching: Input  " << inStats.beats << " beats";
+    if (inStats.beats > 0) {
+        std::cout << ", " << inStats.beatsPerCycle() << " beats/cycle (" << inStats.beatsPerCycle() * IN_WIDTH
+                  << " bits/cycle)";
+    }
+    std::cout << ", " << inStats.stallCycles << " cycles stalled on din_ready" << std::endl;
+    std::cout << "RateMatching: Output " << outStats.beats << " beats";
+    if (outStats.beats > 0) {
+        std::cout << ", " << outStats.beatsPerCycle() << " beats/cycle (" << outStats.beatsPerCycle() * OUT_WIDTH
+                  << " bits/cycle)";
+    }
+    std::cout << ", " << outStats.stallCycles << " cycles stalled on dout_ready" << std::endl;
+    std::cout << "RateMatching: " << planCache.size() << " plans, " << planCache.hits() << " hits, "
+              << planCache.misses() << " misses" << std::endl;
+    if (cutThrough) {
+        std::cout << "RateMatching: Cut-through " << cutThroughBlocks << " code blocks, store-and-forward "
+                  << storeForwardBlocks << std::endl;
+    }
+    if (harqStore.hits() + harqStore.misses() > 0) {
+        std::cout << "RateMatching: HARQ store " << harqStore.hits() << " hits, " << harqStore.misses()
+                  << " misses, " << harqStore.evictions() << " evictions, " << harqBlocks
+                  << " code blocks retransmitted from the store" << std::endl;
+    }
+    if (lastOutLatency.count > 0) {
+        std::cout << "RateMatching: Code block latency to first output beat avg " << firstOutLatency.mean()
+                  << ", max " << firstOutLatency.max << " cycles; to last output beat avg "
+                  << lastOutLatency.mean() << ", max " << lastOutLatency.max << " cycles" << std::endl;
+    }
+}
+
+template <int WIDTH, int BEATS>
+void ratematching<WIDTH, BEATS>::writeStats(rmStatsReport& report) const {
+    const std::string module = name();
+    report.add(module, "din_width", IN_WIDTH);
+    report.add(module, "dout_width", OUT_WIDTH);
+    report.add(module, "config", cfgStats);
+    report.add(module, "din", inStats);
+    report.add(module, "dout", outStats);
+    report.add(module, "cfg_fifo_occupancy", cfgOccupancy);
+    report.add(module, "out_fifo_occupancy", outOccupancy);
+    report.add(module, "latency_first_out", firstOutLatency);
+    report.add(module, "latency_last_out", lastOutLatency);
+    report.add(module, "plans", planCache.size());
+    report.add(module, "plan_hits", (double)planCache.hits());
+    report.add(module, "plan_misses", (double)planCache.misses());
+    report.add(module, "cut_through_blocks", (double)cutThroughBlocks);
+    report.add(module, "store_forward_blocks", (double)storeForwardBlocks);
+    report.add(module, "harq_hits", (double)harqStore.hits());
+    report.add(module, "harq_misses", (double)harqStore.misses());
+    report.add(module, "harq_evictions", (double)harqStore.evictions());
+    report.add(module, "harq_blocks", (double)harqBlocks);
+}
+
+// Bus configurations selectable from sc_main
+#define RM_INSTANTIATE(W, B) template class ratematching<W, B>;
+RM_BUS_CONFIGS(RM_INSTANTIATE)
+#undef RM_INSTANTIATE
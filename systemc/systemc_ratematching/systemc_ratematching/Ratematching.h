@@ -6,14 +6,23 @@
 #include <vector>
 #include <queue>
 #include <string>
+#include "rmBuffer.h"
+#include "rmPlan.h"
+#include "rmStats.h"
 
 
+// Default data bus width, and the width of the input and output text lines
 const int sizePort = 128;
-const int numPorts = 11;
-const int MAX_FIFO_SIZE = numPorts * sizePort; //rows * sizePort
-const int outlenRM = 2000; // Output length for rate-matching
 
-const int CFG_WIDTH = 47; // Configuration bus width
+const int CFG_WIDTH = 98; // Configuration bus width
+
+// Bus configurations the source, ratematching and sink templates are built for,
+// as X(width, beats per cycle). Each one is instantiated in its module's .cpp.
+#define RM_BUS_WIDTHS(X) X(128) X(256) X(512)
+#define RM_BUS_CONFIGS(X) \
+    X(128, 1) X(128, 2) X(128, 4) \
+    X(256, 1) X(256, 2) X(256, 4) \
+    X(512, 1) X(512, 2) X(512, 4)
 
 // Structure containing configuration parameters for RateMatching
 struct ratematchingConfig {
@@ -23,43 +32,221 @@ struct ratematchingConfig {
     sc_uint<3> nlayers;       // Number of layers (3 bits)
     sc_uint<4> Qm;            // Modulation type (4 bits)
     sc_uint<6> Nref;          // Reference value for calculations (6 bits)
+    sc_uint<8> C;             // Number of code blocks in the transport block, 0 = single block (8 bits)
+    sc_uint<24> G;            // Transport block output length for C code blocks (24 bits)
+    sc_uint<14> F;            // Filler bits K - K' of each code block (14 bits)
+    sc_uint<4> harqId;        // HARQ process the codeword is stored for (4 bits)
+    bool retransmit = false;  // Same codeword as the last one of the process, with a new rv (1 bit)
+
+    // Code blocks of the transport block, 1 in single block mode
+    int codeBlocks() const { return (C != 0) ? (int)C : 1; }
+
+    // Output bits of the transport block, outlen in single block mode
+    int tbOutputBits() const { return (C != 0) ? (int)G : (int)outlen; }
+};
+
+// Unpack a configuration bus word
+ratematchingConfig toRatematchingConfig(const sc_lv<CFG_WIDTH>& data);
+
+// Pack a configuration into a bus word
+sc_lv<CFG_WIDTH> toConfigData(const ratematchingConfig& config);
+
+// Bus word to packed 64-bit words in the rmKernel bit order, bit W-1 first
+template <int W>
+inline void lvToWords(const sc_lv<W>& data, uint64_t* words) {
+    for (int i = 0; i < W / 64; ++i) {
+        words[i] = data.range(W - 1 - 64 * i, W - 64 - 64 * i).to_uint64();
+    }
+}
+
+template <int W>
+inline void wordsToLv(const uint64_t* words, sc_lv<W>& data) {
+    for (int i = 0; i < W / 64; ++i) {
+        data.range(W - 1 - 64 * i, W - 64 - 64 * i) = words[i];
+    }
+}
+
+// Rate-matched output of one code block waiting for the egress stage
+struct ratematchingOutput {
+    std::vector<uint64_t> words;  // Packed output beats
+    int beats = 0;                // Number of beats to send
+    int ready = 0;                // Beats computed so far, all of them once the code block is complete
+    bool last = false;            // Last beat ends the transport block
+    long long startCycle = 0;     // Arrival cycle of the first input beat of the code block
 };
 
-SC_MODULE(ratematching) {
+// One beat waiting in the output FIFO
+template <int WORDS>
+struct ratematchingBeat {
+    uint64_t w[WORDS];            // Beat data, first 64 bits in w[0]
+    bool last;                    // dout_last
+    bool blockStart;              // First beat of its code block
+    bool blockEnd;                // Last beat of its code block
+    long long startCycle;         // Arrival cycle of the first input beat of the code block
+};
+
+// Rate matching with a WIDTH-bit din and BEATS beats of WIDTH bits per cycle
+// on dout, a WIDTH * BEATS bit bus. Code blocks arrive padded to whole din
+// beats, transport blocks leave padded to whole dout words.
+template <int WIDTH = sizePort, int BEATS = 1>
+class ratematching : public sc_module {
 public:
+    static const int IN_WIDTH = WIDTH;
+    static const int OUT_WIDTH = WIDTH * BEATS;
+
     // Ports
     sc_in<bool>             clk;            // Clock
     sc_in<bool>             rst;            // Reset
 
-    sc_in<sc_lv<128>>       din_data;       // 128-bit input data
+    sc_in<sc_lv<IN_WIDTH>>  din_data;       // Input data, one beat
     sc_in<bool>             din_valid;      // Valid signal from input
     sc_in<bool>             din_last;
     sc_out<bool>            din_ready;      // Ready signal to input
 
-    sc_out<sc_lv<128>>      dout_data;      // 128-bit output data
+    sc_out<sc_lv<OUT_WIDTH>> dout_data;     // Output data, BEATS beats
     sc_out<bool>            dout_valid;     // Valid signal to output
     sc_out<bool>            dout_last;
     sc_in<bool>             dout_ready;     // Ready signal from output
 
-    // Configuration bus input as a 47-bit signal
+    // Configuration bus input as a 98-bit signal
     sc_in<sc_lv<CFG_WIDTH>> config_data;
     sc_in<bool>             config_valid;
     sc_out<bool>            config_ready;
 
-    // Constructor
-    SC_CTOR(ratematching) {
+    // HARQ status of each retransmission, in configuration order: harq_hit when
+    // its code blocks come from the HARQ store, otherwise they are expected on
+    // din again. Given as its configuration is bound, held until harq_ready.
+    sc_out<bool>            harq_valid;
+    sc_out<bool>            harq_hit;
+    sc_in<bool>             harq_ready;
+
+    // Constructor, outFifoDepth is the depth of the output FIFO in dout words (2 = skid buffer),
+    // cfgFifoDepth the number of configurations queued ahead of their transport blocks
+    SC_HAS_PROCESS(ratematching);
+    ratematching(sc_module_name name, int outFifoDepth = 2, int cfgFifoDepth = 4)
+        : sc_module(name), cfgFifoDepth(cfgFifoDepth < 1 ? 1 : cfgFifoDepth),
+          outFifoDepth(outFifoDepth < 1 ? 1 : outFifoDepth) {
+        SC_THREAD(ingestfunction);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
+
         SC_THREAD(ratematchingfunction);
         sensitive << clk.pos();
         async_reset_signal_is(rst, true);
+
+        SC_THREAD(egressfunction);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
     }
 
+    // Cut-through: start a code block on its first beat and send each output
+    // beat once the input bits it depends on are in (rmPlan::prefix), instead
+    // of after the whole block. Blocks whose first output beat needs the whole
+    // block are still stored and forwarded. Off by default.
+    void setCutThrough(bool on) { cutThrough = on; }
+
+    // Size of the HARQ codeword store in bits, RM_HARQ_CAPACITY by default.
+    // Every transport block received is stored for its HARQ process; a
+    // retransmission found in the store takes its code blocks from there, one
+    // per cycle, and nothing is received on din. 0 disables the store, every
+    // retransmission is then received again. See harq_hit.
+    void setHarqCapacity(long long bits) { harqStore.setCapacity(bits); }
+
+    // Print the achieved input and output beats per cycle, stalls, latency and plan cache use
+    void reportThroughput() const;
+
+    // Add the handshake, FIFO occupancy and latency counters to a report
+    void writeStats(rmStatsReport& report) const;
+
+    // din and dout handshake counters
+    const rmStreamStats& inputStats() const { return inStats; }
+    const rmStreamStats& outputStats() const { return outStats; }
+
 private:
-    // Internal FIFO buffer for data
-    std::queue<sc_lv<MAX_FIFO_SIZE>> dataFIFO;
-    bool allDataWritten = false; // Flag to indicate when all data has been pushed
+    static const int IN_WORDS = IN_WIDTH / 64;
+    static const int OUT_WORDS = OUT_WIDTH / 64;
+
+    // Configurations received ahead of their data. Each one is bound to the
+    // next transport block (C code blocks, or one when C = 0).
+    const int cfgFifoDepth;
+    std::queue<ratematchingConfig> cfgFifo;
+
+    // The threads hand the ping-pong buffers over through signals, each written by
+    // one thread only, so the other thread sees a handoff on the next clock edge
+    // whatever order the threads run in. A buffer is full (started) while its
+    // fill (start) phase differs from its free phase.
+
+    // Ping-pong code block buffers between ingest and rate matching,
+    // each sized from config.inlen and reused across codewords
+    rmCircularBuffer cbBuffer[2];
+    sc_signal<bool> cbFillPhase[2];     // Toggled by ingest once the block is complete
+    sc_signal<bool> cbStartPhase[2];    // Toggled by ingest on the first beat, cbConfig and cbBlockIndex valid
+    sc_signal<bool> cbFreePhase[2];     // Toggled by rate matching when the buffer goes back
+    sc_signal<int> cbBeats[2];          // Beats received into each buffer, written by ingest
+    ratematchingConfig cbConfig[2];     // Configuration of the block held in each buffer
+    int cbBlockIndex[2] = { 0, 0 };     // Index r of that block in its transport block
+    long long cbStartCycle[2] = { 0, 0 }; // Arrival cycle of the first beat of that block
+
+    // Ping-pong output buffers between rate matching and egress, in dout words
+    ratematchingOutput outBuffer[2];
+    sc_signal<bool> outFillPhase[2];    // Toggled by rate matching when it hands the buffer over
+    sc_signal<bool> outFreePhase[2];    // Toggled by egress once every beat is in the FIFO
+    sc_signal<int> outReady[2];         // ratematchingOutput::ready, written by rate matching
+
+    // Output FIFO in front of dout, drained only when dout_ready is high
+    const int outFifoDepth;
+    std::queue<ratematchingBeat<OUT_WORDS>> outFifo;
+
+    // Codewords of the HARQ processes, and the code blocks taken from there
+    rmHarqStore harqStore;
+    std::queue<bool> harqStatus;        // harq_hit of the retransmissions bound, not yet taken
+    long long harqBlocks = 0;
+
+    // Rate matching plans of the configurations seen so far
+    rmPlanCache planCache;
+
+    // Cut-through output, and the code blocks sent each way
+    bool cutThrough = false;
+    long long cutThroughBlocks = 0;
+    long long storeForwardBlocks = 0;
+
+    // Kernel work buffers, grown on configuration only
+    std::vector<uint64_t> selectedBits;
+    std::vector<uint64_t> rateMatchedData;
+
+    // Transport block state (code block concatenation, TS 38.212 5.5)
+    uint64_t tbCarry[OUT_WORDS] = {};  // Output bits of the previous block not yet sent
+    int tbCarryBits = 0;
+
+    // Handshakes and FIFO occupancy, sampled every cycle by the stage owning them
+    rmStreamStats cfgStats, inStats, outStats;
+    rmOccupancyStats cfgOccupancy, outOccupancy;
+
+    // Code block latency in cycles from the first input beat to the first and to the last output beat
+    rmLatencyStats firstOutLatency, lastOutLatency;
+
+    // Receives the configurations and code blocks into the ping-pong buffers
+    void ingestfunction();
 
     // Internal function for rate matching logic
     void ratematchingfunction();
+
+    // Sends the rate-matched beats on dout
+    void egressfunction();
+
+    // Size the work buffers for the given configuration
+    void reserveBuffers(const ratematchingConfig& cfg);
+
+    // Buffer states as of the last clock edge
+    bool cbFull(int b) const { return cbFillPhase[b].read() != cbFreePhase[b].read(); }
+    bool cbStarted(int b) const { return cbStartPhase[b].read() != cbFreePhase[b].read(); }
+    bool outFull(int b) const { return outFillPhase[b].read() != outFreePhase[b].read(); }
+
+    // Flip a phase signal, once per cycle at most
+    static void toggle(sc_signal<bool>& phase) { phase.write(!phase.read()); }
+
+    // Output bits of the code block in cbBuffer[b] and the carry, as whole dout words
+    void assembleOutput(int b, const rmPlan& plan, ratematchingOutput& out);
 };
 
 #endif // RATEMATCHING_H
\ No newline at end of file
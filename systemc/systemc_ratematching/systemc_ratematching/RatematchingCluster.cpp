@@ -0,0 +1,461 @@
+/*
+ * ==============================================
+ * File:        RatematchingCluster.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Multi-lane rate matching. A dispatcher splits
+ *              the transport blocks into code blocks and sends
+ *              each one with its own configuration to a free
+ *              lane; a collector takes the lane outputs back in
+ *              arrival order and concatenates them on one dout.
+ *
+ *  - A code block goes to a lane as a transport block of one
+ *    block with G = E, so the lane outputs exactly its E bits,
+ *    padded to whole dout words.
+ *  - The collector drops that padding and carries the bits
+ *    left over from one block into the next, as ratematching
+ *    does for the blocks of a transport block.
+ *  - A lane holds at most two code blocks, one per ping-pong
+ *    buffer; the busy cycles of each lane and the cycles a
+ *    block waited for a lane size the cluster for a deadline.
+ *  - The HARQ store sits in the dispatcher, in front of the
+ *    lanes: a retransmitted codeword is sent to them from the
+ *    store instead of din.
+ * ==============================================
+ */
+
+#include "RatematchingCluster.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include "rmKernel.h"
+#include "Log.h"
+
+template <int WIDTH, int BEATS>
+ratematchingCluster<WIDTH, BEATS>::ratematchingCluster(sc_module_name name, int lanes, int outFifoDepth,
+                                                       int cfgFifoDepth)
+    : sc_module(name), numLanes(lanes < 1 ? 1 : lanes), cfgFifoDepth(cfgFifoDepth < 1 ? 1 : cfgFifoDepth),
+      outFifoDepth(outFifoDepth < 1 ? 1 : outFifoDepth), laneCfg(numLanes), laneDispatched(numLanes, 0),
+      laneStats(numLanes) {
+    for (int i = 0; i < numLanes; ++i) {
+        laneBus.emplace_back(new laneSignals);
+        laneSignals& bus = *laneBus.back();
+        std::string laneName = "lane" + std::to_string(i);
+        this->lanes.emplace_back(new ratematching<WIDTH, BEATS>(laneName.c_str(), outFifoDepth, cfgFifoDepth));
+        ratematching<WIDTH, BEATS>& lane = *this->lanes.back();
+        lane.clk(clk);
+        lane.rst(rst);
+        lane.config_data(bus.config_data);
+        lane.config_valid(bus.config_valid);
+        lane.config_ready(bus.config_ready);
+        lane.din_data(bus.din_data);
+        lane.din_valid(bus.din_valid);
+        lane.din_ready(bus.din_ready);
+        lane.din_last(bus.din_last);
+        lane.dout_data(bus.dout_data);
+        lane.dout_valid(bus.dout_valid);
+        lane.dout_ready(bus.dout_ready);
+        lane.dout_last(bus.dout_last);
+        lane.harq_valid(bus.harq_valid);
+        lane.harq_hit(bus.harq_hit);
+        lane.harq_ready(bus.harq_ready);
+        lane.setHarqCapacity(0);
+    }
+
+    SC_THREAD(dispatchfunction);
+    sensitive << clk.pos();
+    async_reset_signal_is(rst, true);
+
+    SC_THREAD(collectfunction);
+    sensitive << clk.pos();
+    async_reset_signal_is(rst, true);
+}
+
+template <int WIDTH, int BEATS>
+int ratematchingCluster<WIDTH, BEATS>::pickLane() const {
+    int best = -1;
+    for (int k = 0; k < numLanes; ++k) {
+        int i = (nextLane + k) % numLanes;
+        if (outstanding(i) < LANE_DEPTH && (best < 0 || outstanding(i) < outstanding(best))) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template <int WIDTH, int BEATS>
+void ratematchingCluster<WIDTH, BEATS>::dispatchfunction() {
+
+    ratematchingConfig config;  // Configuration of the transport block being received
+    bool active = false;        // A transport block is bound to config
+    int cbIndex = 0;            // Index r of the next code block in the transport block
+    int lane = -1;              // Lane of the code block being received, -1 = none yet
+    int beats = 0;              // Beats of that code block received so far
+    bool replay = false;        // The code blocks of the transport block come from the HARQ store
+
+    din_ready.write(false);
+    config_ready.write(false);
+    harq_valid.write(false);
+    harq_hit.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            din_ready.write(false);
+            config_ready.write(false);
+            harq_valid.write(false);
+            harq_hit.write(false);
+            harqStatus = std::queue<bool>();
+            for (int i = 0; i < numLanes; ++i) {
+                laneBus[i]->config_valid.write(false);
+                laneBus[i]->din_valid.write(false);
+                laneBus[i]->din_last.write(false);
+                laneCfg[i] = std::queue<ratematchingConfig>();
+                laneDispatched[i] = 0;
+            }
+            cfgFifo = std::queue<ratematchingConfig>();
+            beatFifo.clear();
+            jobs.clear();
+            jobsDispatched.write(0);
+            harqStore.clear();
+            storeWords.clear();
+            nextLane = 0;
+            active = false;
+            replay = false;
+            cbIndex = 0;
+            lane = -1;
+            continue; // Move to next cycle
+        }
+
+        cfgStats.sample(config_valid.read(), config_ready.read());
+        inStats.sample(din_valid.read(), din_ready.read());
+
+        int busy = 0;
+        for (int i = 0; i < numLanes; ++i) {
+            if (outstanding(i) > 0) {
+                ++laneStats[i].busyCycles;
+                ++busy;
+            }
+        }
+        busyLanes.sample(busy);
+
+        if (config_valid.read() && config_ready.read()) {
+            cfgFifo.push(toRatematchingConfig(config_data.read()));
+            RM_LOG(SC_HIGH, name(), "Configuration received and queued");
+        }
+        if (harq_valid.read() && harq_ready.read()) {
+            harqStatus.pop();
+        }
+
+        // Lane handshakes of the previous cycle
+        for (int i = 0; i < numLanes; ++i) {
+            laneSignals& bus = *laneBus[i];
+            if (bus.config_valid.read() && bus.config_ready.read()) {
+                laneCfg[i].pop();
+            }
+            if (bus.din_valid.read() && bus.din_ready.read()) {
+                beatFifo.pop_front();
+            }
+        }
+
+        // The next beat of the code block, from din or from the HARQ store
+        bool fromDin = din_valid.read() && din_ready.read();
+        bool fromStore = active && replay && lane >= 0 && beatFifo.size() < 2;
+        if (fromDin || fromStore) {
+            int blockBeats = ((int)config.inlen + IN_WIDTH - 1) / IN_WIDTH;
+            sc_lv<IN_WIDTH> data;
+            if (fromDin) {
+                data = din_data.read();
+                uint64_t words[IN_WORDS];
+                lvToWords(data, words);
+                storeWords.insert(storeWords.end(), words, words + IN_WORDS);
+            }
+            else {
+                wordsToLv(harqStore.block(config.harqId, cbIndex) + IN_WORDS * beats, data);
+            }
+
+            // A code block ends on din_last or once it fills the buffer of its lane
+            bool blockEnd = (fromDin && din_last.read()) || ++beats >= blockBeats;
+            beatFifo.push_back({ data, lane, blockEnd });
+            if (blockEnd) {
+                int C = config.codeBlocks();
+                if (fromDin) {
+                    storeWords.resize(IN_WORDS * blockBeats);
+                    harqStore.put(config.harqId, cbIndex, storeWords.data());
+                    storeWords.clear();
+                }
+                else {
+                    ++harqBlocks;
+                }
+                cbIndex = (cbIndex + 1 < C) ? cbIndex + 1 : 0;
+                lane = -1;
+                if (cbIndex == 0) {
+                    active = false;
+                    replay = false;
+                }
+            }
+        }
+
+        if (!active && !cfgFifo.empty()) {
+            config = cfgFifo.front();
+            cfgFifo.pop();
+            active = true;
+            cbIndex = 0;
+
+            // As ratematching: a stored retransmission is replayed, anything else is stored
+            int C = config.codeBlocks();
+            replay = config.retransmit && harqStore.lookup(config.harqId, config.inlen, C);
+            if (!replay) {
+                harqStore.begin(config.harqId, config.inlen, C, IN_WIDTH);
+            }
+            if (config.retransmit) {
+                harqStatus.push(replay);
+            }
+        }
+
+        // Assign the next code block to a lane, ahead of its first beat
+        if (active && lane < 0) {
+            lane = pickLane();
+            if (lane >= 0) {
+                int C = config.codeBlocks();
+                int G = config.tbOutputBits();
+                int E = rmBlockE(G, C, cbIndex, config.nlayers, config.Qm);
+
+                ratematchingConfig laneConfig = config;
+                laneConfig.C = 1;
+                laneConfig.G = E;
+                laneConfig.retransmit = false;
+                laneCfg[lane].push(laneConfig);
+                jobs.push_back({ lane, E, cbIndex == C - 1 });
+                jobsDispatched.write(jobsDispatched.read() + 1);
+                ++laneDispatched[lane];
+                ++laneStats[lane].blocks;
+                nextLane = (lane + 1) % numLanes;
+                beats = 0;
+                RM_LOG(SC_FULL, name(), "Code block " << cbIndex + 1 << " of " << C << " to lane " << lane);
+            }
+            else if (din_valid.read() || replay) {
+                ++noLaneCycles;
+            }
+        }
+
+        // The beats go to their lane in order, each lane sees only its own blocks
+        for (int i = 0; i < numLanes; ++i) {
+            laneSignals& bus = *laneBus[i];
+            bus.config_valid.write(!laneCfg[i].empty());
+            if (!laneCfg[i].empty()) {
+                bus.config_data.write(toConfigData(laneCfg[i].front()));
+            }
+            bool head = !beatFifo.empty() && beatFifo.front().lane == i;
+            bus.din_valid.write(head);
+            bus.din_last.write(head && beatFifo.front().last);
+            if (head) {
+                bus.din_data.write(beatFifo.front().data);
+            }
+        }
+
+        config_ready.write((int)cfgFifo.size() < cfgFifoDepth);
+        din_ready.write(active && !replay && lane >= 0 && beatFifo.size() < 2);
+        harq_valid.write(!harqStatus.empty());
+        harq_hit.write(!harqStatus.empty() && harqStatus.front());
+    }
+}
+
+template <int WIDTH, int BEATS>
+bool ratematchingCluster<WIDTH, BEATS>::appendBits(const uint64_t* w, int n) {
+    rmCopyBits(carry, carryBits, w, 0, n);
+    carryBits += n;
+    if (carryBits < OUT_WIDTH) {
+        return false;
+    }
+
+    collectBeat beat;
+    std::copy(carry, carry + OUT_WORDS, beat.w);
+    beat.last = false;
+    outFifo.push_back(beat);
+
+    // Bits past the dout word move to the front, everything after them stays 0
+    carryBits -= OUT_WIDTH;
+    uint64_t rest[OUT_WORDS] = {};
+    rmCopyBits(rest, 0, carry, OUT_WIDTH, carryBits);
+    std::copy(rest, rest + OUT_WORDS, carry);
+    std::fill(carry + OUT_WORDS, carry + 2 * OUT_WORDS, 0);
+    return true;
+}
+
+template <int WIDTH, int BEATS>
+void ratematchingCluster<WIDTH, BEATS>::collectfunction() {
+
+    int taken = 0;       // Output bits of the oldest code block collected so far
+    bool flush = false;  // The padded last word of a transport block is waiting for the FIFO
+
+    dout_valid.write(false);
+    dout_last.write(false);
+
+    while (true) {
+        wait(); // Wait for clock edge
+
+        // Reset condition
+        if (rst.read()) {
+            dout_valid.write(false);
+            dout_last.write(false);
+            for (int i = 0; i < numLanes; ++i) {
+                laneBus[i]->dout_ready.write(false);
+                laneBus[i]->collected.write(0);
+            }
+            jobsCollected = 0;
+            outFifo.clear();
+            std::fill(carry, carry + 2 * OUT_WORDS, 0);
+            carryBits = 0;
+            taken = 0;
+            flush = false;
+            continue; // Move to next cycle
+        }
+
+        outStats.sample(dout_valid.read(), dout_ready.read());
+        if (dout_valid.read() && dout_ready.read()) {
+            outFifo.pop_front();
+        }
+
+        // The padded rest of a transport block goes out as its last word
+        if (flush && (int)outFifo.size() < outFifoDepth) {
+            collectBeat beat;
+            std::copy(carry, carry + OUT_WORDS, beat.w);
+            beat.last = true;
+            outFifo.push_back(beat);
+            std::fill(carry, carry + 2 * OUT_WORDS, 0);
+            carryBits = 0;
+            flush = false;
+        }
+
+        // One word of the oldest code block, only its first E bits are output
+        size_t visible = (size_t)(jobsDispatched.read() - jobsCollected);
+        if (visible > 0) {
+            const ratematchingLaneJob& job = jobs.front();
+            laneSignals& bus = *laneBus[job.lane];
+            bool pushed = false;
+            bool blockEnd = (job.E == 0);  // No output to wait for
+            if (bus.dout_valid.read() && bus.dout_ready.read()) {
+                uint64_t w[OUT_WORDS];
+                lvToWords(bus.dout_data.read(), w);
+                int n = std::min(OUT_WIDTH, job.E - taken);
+                pushed = appendBits(w, n);
+                taken += n;
+                blockEnd = bus.dout_last.read();
+            }
+            else if (!blockEnd) {
+                for (size_t k = 1; k < visible; ++k) {
+                    if (laneBus[jobs[k].lane]->dout_valid.read() && jobs[k].lane != job.lane) {
+                        ++reorderCycles;
+                        break;
+                    }
+                }
+            }
+
+            if (blockEnd) {
+                if (job.last) {
+                    if (carryBits > 0) {
+                        flush = true;
+                    }
+                    else if (pushed) {
+                        outFifo.back().last = true;
+                    }
+                }
+                bus.collected.write(bus.collected.read() + 1);
+                jobs.pop_front();
+                ++jobsCollected;
+                --visible;
+                taken = 0;
+            }
+        }
+
+        // Only the lane of the oldest block may send, and only into a free FIFO entry
+        for (int i = 0; i < numLanes; ++i) {
+            bool ready = !flush && visible > 0 && jobs.front().lane == i && (int)outFifo.size() < outFifoDepth;
+            laneBus[i]->dout_ready.write(ready);
+        }
+
+        if (!outFifo.empty()) {
+            sc_lv<OUT_WIDTH> data;
+            wordsToLv(outFifo.front().w, data);
+            dout_data.write(data);
+            dout_valid.write(true);
+            dout_last.write(outFifo.front().last);
+        }
+        else {
+            dout_valid.write(false);
+            dout_last.write(false);
+        }
+    }
+}
+
+template <int WIDTH, int BEATS>
+void ratematchingCluster<WIDTH, BEATS>::reportThroughput() const {
+    std::cout << "RateMatching: " << numLanes << " lanes, " << IN_WIDTH << "-bit din, " << BEATS << " x " << WIDTH
+              << "-bit dout" << std::endl;
+    std::cout << "RateMatching: Input  " << inStats.beats << " beats";
+    if (inStats.beats > 0) {
+        std::cout << ", " << inStats.beatsPerCycle() << " beats/cycle (" << inStats.beatsPerCycle() * IN_WIDTH
+                  << " bits/cycle)";
+    }
+    std::cout << ", " << inStats.stallCycles << " cycles stalled on din_ready" << std::endl;
+    std::cout << "RateMatching: Output " << outStats.beats << " beats";
+    if (outStats.beats > 0) {
+        std::cout << ", " << outStats.beatsPerCycle() << " beats/cycle (" << outStats.beatsPerCycle() * OUT_WIDTH
+                  << " bits/cycle)";
+    }
+    std::cout << ", " << outStats.stallCycles << " cycles stalled on dout_ready" << std::endl;
+
+    // Utilisation over the cycles from the first input beat to the last output beat
+    long long window = (inStats.firstBeat >= 0 && outStats.lastBeat >= inStats.firstBeat)
+                           ? outStats.lastBeat - inStats.firstBeat + 1 : inStats.cycles;
+    std::cout << "RateMatching: " << window << " cycles from first input to last output beat, lanes busy avg "
+              << busyLanes.mean() << ", max " << busyLanes.max() << "; " << noLaneCycles
+              << " cycles waiting for a free lane, " << reorderCycles << " cycles waiting to reorder" << std::endl;
+    for (int i = 0; i < numLanes; ++i) {
+        std::cout << "RateMatching: Lane " << i << ": " << laneStats[i].blocks << " code blocks, busy "
+                  << (window > 0 ? 100.0 * laneStats[i].busyCycles / window : 0.0) << "% ("
+                  << laneStats[i].busyCycles << " cycles)" << std::endl;
+    }
+    if (harqStore.hits() + harqStore.misses() > 0) {
+        std::cout << "RateMatching: HARQ store " << harqStore.hits() << " hits, " << harqStore.misses()
+                  << " misses, " << harqStore.evictions() << " evictions, " << harqBlocks
+                  << " code blocks retransmitted from the store" << std::endl;
+    }
+}
+
+template <int WIDTH, int BEATS>
+void ratematchingCluster<WIDTH, BEATS>::writeStats(rmStatsReport& report) const {
+    const std::string module = name();
+    report.add(module, "lanes", numLanes);
+    report.add(module, "din_width", IN_WIDTH);
+    report.add(module, "dout_width", OUT_WIDTH);
+    report.add(module, "config", cfgStats);
+    report.add(module, "din", inStats);
+    report.add(module, "dout", outStats);
+    report.add(module, "busy_lanes", busyLanes);
+    report.add(module, "no_lane_cycles", (double)noLaneCycles);
+    report.add(module, "reorder_cycles", (double)reorderCycles);
+    report.add(module, "harq_hits", (double)harqStore.hits());
+    report.add(module, "harq_misses", (double)harqStore.misses());
+    report.add(module, "harq_evictions", (double)harqStore.evictions());
+    report.add(module, "harq_blocks", (double)harqBlocks);
+    for (int i = 0; i < numLanes; ++i) {
+        std::string lane = "lane" + std::to_string(i);
+        report.add(module, lane + "_blocks", (double)laneStats[i].blocks);
+        report.add(module, lane + "_busy_cycles", (double)laneStats[i].busyCycles);
+    }
+    for (const auto& lane : lanes) {
+        lane->writeStats(report);
+    }
+}
+
+// Bus configurations selectable from sc_main
+#define RM_INSTANTIATE(W, B) template class ratematchingCluster<W, B>;
+RM_BUS_CONFIGS(RM_INSTANTIATE)
+#undef RM_INSTANTIATE
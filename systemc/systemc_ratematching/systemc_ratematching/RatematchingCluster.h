@@ -0,0 +1,176 @@
+// RatematchingCluster.h
+
+#ifndef RATEMATCHINGCLUSTER_H
+#define RATEMATCHINGCLUSTER_H
+
+#include <systemc.h>
+#include <deque>
+#include <memory>
+#include <queue>
+#include <vector>
+#include "ratematching.h"
+#include "rmStats.h"
+
+// Signals between the dispatcher or the collector and one lane
+template <int IN_WIDTH, int OUT_WIDTH>
+struct ratematchingLaneSignals {
+    sc_signal<sc_lv<CFG_WIDTH>> config_data;
+    sc_signal<bool> config_valid, config_ready;
+    sc_signal<sc_lv<IN_WIDTH>> din_data;
+    sc_signal<bool> din_valid, din_ready, din_last;
+    sc_signal<sc_lv<OUT_WIDTH>> dout_data;
+    sc_signal<bool> dout_valid, dout_ready, dout_last;
+    sc_signal<bool> harq_valid, harq_hit, harq_ready;   // Unused, the dispatcher holds the store
+    sc_signal<long long> collected;                     // Code blocks of the lane collected so far
+};
+
+// Code block dispatched to a lane, in the order the blocks arrived
+struct ratematchingLaneJob {
+    int lane;                     // Lane rate matching the block
+    int E;                        // Output bits of the block
+    bool last;                    // Last block of its transport block
+};
+
+// Cycles and code blocks of one lane
+struct ratematchingLaneStats {
+    long long blocks = 0;         // Code blocks dispatched to the lane
+    long long busyCycles = 0;     // Cycles with a block dispatched and not yet collected
+};
+
+// N rate matching lanes behind a dispatcher and an in-order collector, with
+// the ports of ratematching. The dispatcher hands each code block to the
+// least loaded lane as a single-block transport block (C = 1, G = E); the
+// collector takes the lane outputs back in arrival order, drops the padding
+// of each lane and concatenates the code blocks of a transport block on one
+// dout, so the output is the same as a single ratematching.
+template <int WIDTH = sizePort, int BEATS = 1>
+class ratematchingCluster : public sc_module {
+public:
+    static const int IN_WIDTH = WIDTH;
+    static const int OUT_WIDTH = WIDTH * BEATS;
+
+    // Ports, as ratematching
+    sc_in<bool>             clk;
+    sc_in<bool>             rst;
+
+    sc_in<sc_lv<IN_WIDTH>>  din_data;
+    sc_in<bool>             din_valid;
+    sc_in<bool>             din_last;
+    sc_out<bool>            din_ready;
+
+    sc_out<sc_lv<OUT_WIDTH>> dout_data;
+    sc_out<bool>            dout_valid;
+    sc_out<bool>            dout_last;
+    sc_in<bool>             dout_ready;
+
+    sc_in<sc_lv<CFG_WIDTH>> config_data;
+    sc_in<bool>             config_valid;
+    sc_out<bool>            config_ready;
+
+    sc_out<bool>            harq_valid;
+    sc_out<bool>            harq_hit;
+    sc_in<bool>             harq_ready;
+
+    // Constructor, lanes rate matching instances; the FIFO depths are those of
+    // ratematching, used by every lane and by the collector
+    SC_HAS_PROCESS(ratematchingCluster);
+    ratematchingCluster(sc_module_name name, int lanes = 2, int outFifoDepth = 2, int cfgFifoDepth = 4);
+
+    // Cut-through output in every lane, see ratematching::setCutThrough
+    void setCutThrough(bool on) {
+        for (const auto& lane : lanes) {
+            lane->setCutThrough(on);
+        }
+    }
+
+    // Size of the HARQ codeword store of the dispatcher in bits, see
+    // ratematching::setHarqCapacity. A stored codeword goes back to the lanes
+    // one beat per cycle in place of din; the lanes store nothing themselves.
+    void setHarqCapacity(long long bits) { harqStore.setCapacity(bits); }
+
+    // Print the throughput of the cluster and the utilisation of each lane
+    void reportThroughput() const;
+
+    // Add the cluster and lane counters to a report
+    void writeStats(rmStatsReport& report) const;
+
+    // din and dout handshake counters of the cluster
+    const rmStreamStats& inputStats() const { return inStats; }
+    const rmStreamStats& outputStats() const { return outStats; }
+
+private:
+    static const int IN_WORDS = IN_WIDTH / 64;
+    static const int OUT_WORDS = OUT_WIDTH / 64;
+
+    // Code blocks a lane may hold at once, one per ping-pong buffer
+    static const int LANE_DEPTH = 2;
+
+    typedef ratematchingLaneSignals<IN_WIDTH, OUT_WIDTH> laneSignals;
+
+    const int numLanes;
+    const int cfgFifoDepth;
+    const int outFifoDepth;
+    std::vector<std::unique_ptr<laneSignals>> laneBus;
+    std::vector<std::unique_ptr<ratematching<WIDTH, BEATS>>> lanes;
+
+    // Dispatcher: transport block configurations, and the din beats on their
+    // way to the lane of their code block
+    struct dispatchBeat {
+        sc_lv<IN_WIDTH> data;
+        int lane;
+        bool last;                // Last beat of the code block
+    };
+    std::queue<ratematchingConfig> cfgFifo;
+    std::deque<dispatchBeat> beatFifo;
+    std::vector<std::queue<ratematchingConfig>> laneCfg;  // Configurations not yet taken by each lane
+
+    // Codewords of the HARQ processes, the code block being stored and the blocks replayed
+    rmHarqStore harqStore;
+    std::queue<bool> harqStatus;
+    std::vector<uint64_t> storeWords;
+    long long harqBlocks = 0;
+
+    // Blocks dispatched and not yet collected. The dispatcher appends to jobs and
+    // counts them on a signal, the collector counts the blocks of each lane it is
+    // done with on a signal, so each thread sees the other's progress on the next
+    // clock edge whatever order they run in.
+    std::deque<ratematchingLaneJob> jobs;
+    sc_signal<long long> jobsDispatched;      // Written by the dispatcher
+    long long jobsCollected = 0;              // Collector's own count
+    std::vector<long long> laneDispatched;    // Per lane, dispatcher's own count
+    int nextLane = 0;                         // First lane tried for the next code block
+
+    // Collector: output bits not yet in a whole dout word, and the dout FIFO
+    uint64_t carry[2 * OUT_WORDS] = {};
+    int carryBits = 0;
+    struct collectBeat {
+        uint64_t w[OUT_WORDS];
+        bool last;
+    };
+    std::deque<collectBeat> outFifo;
+
+    // Handshakes, lane use and the cycles lost to the lanes
+    rmStreamStats cfgStats, inStats, outStats;
+    std::vector<ratematchingLaneStats> laneStats;
+    rmOccupancyStats busyLanes;   // Lanes holding a code block, per cycle
+    long long noLaneCycles = 0;   // A code block waiting with every lane full
+    long long reorderCycles = 0;  // Collector waiting on the oldest block while a later one is ready
+
+    // Splits the transport blocks into code blocks for the lanes
+    void dispatchfunction();
+
+    // Merges the lane outputs back into order on dout
+    void collectfunction();
+
+    // Least loaded lane for the next code block, starting from nextLane on a
+    // tie; -1 when every lane is full
+    int pickLane() const;
+
+    // Code blocks of a lane not yet collected, as of the last clock edge
+    int outstanding(int lane) const { return (int)(laneDispatched[lane] - laneBus[lane]->collected.read()); }
+
+    // Append n bits of a lane output word to the carry, moving whole dout words to the FIFO
+    bool appendBits(const uint64_t* w, int n);
+};
+
+#endif // RATEMATCHINGCLUSTER_H
@@ -0,0 +1,123 @@
+/*
+ * ==============================================
+ * File:        RatematchingTlm.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Loosely-timed (TLM-2.0 blocking transport)
+ *              model of the rate matching module for fast
+ *              system level simulation. Each transaction
+ *              carries a whole transport block and is rate
+ *              matched with rmBatch; the cycle count of the
+ *              cycle-accurate pipeline is annotated as delay.
+ * ==============================================
+ */
+
+#include "RatematchingTlm.h"
+#include <algorithm>
+#include <iostream>
+
+// Transport block parameters in the rmBatch form
+static rmTbConfig toTbConfig(const ratematchingConfig& config) {
+    rmTbConfig cfg;
+    cfg.N = config.inlen;
+    cfg.rv = config.rv;
+    cfg.Nref = config.Nref;
+    cfg.nlayers = config.nlayers;
+    cfg.Qm = config.Qm;
+    cfg.C = config.codeBlocks();
+    cfg.G = config.tbOutputBits();
+    cfg.F = config.F;
+    return cfg;
+}
+
+int ratematchingTlm::blockWords(const ratematchingConfig& cfg) {
+    return 2 * (((int)cfg.inlen + sizePort - 1) / sizePort);
+}
+
+int ratematchingTlm::outputWords(const ratematchingConfig& config) {
+    rmTbConfig cfg = toTbConfig(config);
+    int bits = 0;
+    for (int r = 0; r < cfg.C; ++r) {
+        bits += rmBlockE(cfg.G, cfg.C, r, cfg.nlayers, cfg.Qm);
+    }
+    return 2 * ((bits + sizePort - 1) / sizePort);
+}
+
+long long ratematchingTlm::transportCycles(const rmTbConfig& cfg) const {
+    // Ingest takes one beat per cycle into the ping-pong buffers, the output
+    // of a block starts a fixed number of cycles after its last input beat
+    // and is sent one beat per cycle behind the previous block
+    long long inBeats = (cfg.N + sizePort - 1) / sizePort;
+    long long inEnd = 0, outEnd = 0;
+    int bits = 0, sentBeats = 0;
+    for (int r = 0; r < cfg.C; ++r) {
+        inEnd += inBeats;
+        bits += rmBlockE(cfg.G, cfg.C, r, cfg.nlayers, cfg.Qm);
+
+        // Only whole beats leave before the last block
+        int beats = (r == cfg.C - 1) ? (bits + sizePort - 1) / sizePort : bits / sizePort;
+        long long outStart = std::max(inEnd + TLM_PIPELINE_CYCLES, outEnd);
+        outEnd = outStart + (beats - sentBeats);
+        sentBeats = beats;
+    }
+    return outEnd;
+}
+
+void ratematchingTlm::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+    ratematchingExtension* ext = nullptr;
+    trans.get_extension(ext);
+    if (ext == nullptr) {
+        trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+        return;
+    }
+    if (trans.get_command() != tlm::TLM_WRITE_COMMAND) {
+        trans.set_response_status(tlm::TLM_COMMAND_ERROR_RESPONSE);
+        return;
+    }
+
+    // The payload must hold all code blocks and out the whole output
+    rmTbConfig cfg = toTbConfig(ext->config);
+    int stride = blockWords(ext->config);
+    if (cfg.N <= 0 || cfg.Qm <= 0 || cfg.nlayers <= 0
+        || trans.get_data_length() < (unsigned)cfg.C * stride * sizeof(uint64_t)
+        || ext->out == nullptr || ext->outWords < outputWords(ext->config)) {
+        trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+        return;
+    }
+
+    const uint64_t* cb = reinterpret_cast<const uint64_t*>(trans.get_data_ptr());
+    ext->outBits = batch.rateMatch(cfg, cb, ext->out, stride);
+
+    // The rest of the last beat is zero, as on dout
+    int usedWords = rmNumWords(ext->outBits);
+    std::fill(ext->out + usedWords, ext->out + outputWords(ext->config), 0);
+
+    sc_time busy = clockPeriod * (double)transportCycles(cfg);
+    delay += busy;
+
+    ++transportBlocks;
+    inBits += (long long)cfg.C * cfg.N;
+    outBits += ext->outBits;
+    busyTime += busy;
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+}
+
+void ratematchingTlm::writeStats(rmStatsReport& report) const {
+    const std::string module = name();
+    report.add(module, "transport_blocks", (double)transportBlocks);
+    report.add(module, "in_bits", (double)inBits);
+    report.add(module, "out_bits", (double)outBits);
+    report.add(module, "busy_cycles", busyTime / clockPeriod);
+    report.add(module, "plans", batch.plans().size());
+}
+
+void ratematchingTlm::reportThroughput() const {
+    std::cout << "RateMatchingTlm: " << transportBlocks << " transport blocks, " << inBits << " input bits, "
+              << outBits << " output bits, " << busyTime << " busy" << std::endl;
+    const rmPlanCache& plans = batch.plans();
+    std::cout << "RateMatchingTlm: " << plans.size() << " plans, " << plans.hits() << " hits, "
+              << plans.misses() << " misses" << std::endl;
+}
@@ -0,0 +1,74 @@
+// RatematchingTlm.h
+
+#ifndef RATEMATCHINGTLM_H
+#define RATEMATCHINGTLM_H
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_target_socket.h>
+#include <cstdint>
+#include "ratematching.h"
+#include "rmBatch.h"
+
+// Cycles from the last input beat of a code block to its first output beat
+// in the cycle-accurate model
+const int TLM_PIPELINE_CYCLES = 1;
+
+// Transport block parameters and output buffer of a rate matching transaction.
+// The payload data holds the C code blocks, packed in the rmKernel bit order,
+// each starting on a beat boundary (ratematchingTlm::blockWords() words apart).
+struct ratematchingExtension : tlm::tlm_extension<ratematchingExtension> {
+    ratematchingConfig config;   // Same fields as the configuration bus
+    uint64_t* out = nullptr;     // Concatenated output, two words per 128-bit beat
+    int outWords = 0;            // Size of out, at least ratematchingTlm::outputWords()
+    int outBits = 0;             // Set by the target: rate-matched bits written to out
+
+    tlm::tlm_extension_base* clone() const override { return new ratematchingExtension(*this); }
+    void copy_from(const tlm::tlm_extension_base& ext) override {
+        *this = static_cast<const ratematchingExtension&>(ext);
+    }
+};
+
+// Loosely-timed rate matching: one blocking transport call per transport
+// block instead of one clock edge per beat. The result is bit-exact with the
+// ratematching module; the annotated delay is the cycle count that module
+// needs when the sink never stalls.
+SC_MODULE(ratematchingTlm) {
+public:
+    tlm_utils::simple_target_socket<ratematchingTlm> socket;
+
+    SC_HAS_PROCESS(ratematchingTlm);
+    ratematchingTlm(sc_module_name name, sc_time clockPeriod = sc_time(10, SC_NS))
+        : sc_module(name), socket("socket"), clockPeriod(clockPeriod) {
+        socket.register_b_transport(this, &ratematchingTlm::b_transport);
+    }
+
+    // Payload words per code block: whole 128-bit beats of inlen bits
+    static int blockWords(const ratematchingConfig& cfg);
+
+    // Output words needed for a transport block, a whole number of beats
+    static int outputWords(const ratematchingConfig& cfg);
+
+    // Print the transport blocks, bits and simulated time handled so far
+    void reportThroughput() const;
+
+    // Add the transaction counters to a report
+    void writeStats(rmStatsReport& report) const;
+
+private:
+    const sc_time clockPeriod;
+
+    // Plans and work buffers, kept across transactions
+    rmBatch batch;
+
+    long long transportBlocks = 0;
+    long long inBits = 0, outBits = 0;
+    sc_time busyTime;
+
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
+
+    // Clock cycles the cycle-accurate model takes for the transport block
+    long long transportCycles(const rmTbConfig& cfg) const;
+};
+
+#endif // RATEMATCHINGTLM_H
@@ -0,0 +1,237 @@
+/*
+ * ==============================================
+ * File:        Regression.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Regression driver support: reads the test
+ *              case manifest and checks the output stream
+ *              against the expected output of each case on
+ *              the fly, word by word.
+ * ==============================================
+ */
+
+#include "Regression.h"
+#include "myLibrary.h"
+#include "rmKernel.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool isVectorFile(const std::string& path) {
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".rmv") == 0;
+}
+
+bool makeCase(const std::string& cfgPath, const std::string& inPath, const std::string& expectedPath,
+              regressionCase& tc) {
+    tc.cfgPath = cfgPath;
+    tc.inPath = inPath;
+    tc.expectedPath = expectedPath;
+    tc.configs.clear();
+
+    // The records of a vector file carry their configuration
+    if (isVectorFile(inPath)) {
+        rmVectorReader reader;
+        if (!reader.open(inPath)) {
+            return false;
+        }
+        rmVectorRecord rec;
+        while (reader.next(rec)) {
+            tc.configs.push_back(rec);
+        }
+        return true;
+    }
+    return rmReadConfigText(cfgPath, tc.configs);
+}
+
+bool readManifest(const std::string& path, std::vector<regressionCase>& cases) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+
+    // Paths are relative to the directory of the manifest
+    size_t slash = path.find_last_of("/\\");
+    std::string dir = (slash == std::string::npos) ? "" : path.substr(0, slash + 1);
+    auto resolve = [&dir](const std::string& p) -> std::string {
+        if (p == "-") {
+            return "";
+        }
+        bool absolute = p[0] == '/' || p[0] == '\\' || (p.size() > 1 && p[1] == ':');
+        return absolute ? p : dir + p;
+    };
+
+    std::string line;
+    int lineNumber = 0;
+    bool ok = true;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream iss(line);
+        std::string cfg, in, expected;
+        if (!(iss >> cfg) || cfg[0] == '#') {
+            continue;
+        }
+        if (!(iss >> in >> expected)) {
+            std::cerr << "Warning: Incorrect format in manifest line " << lineNumber << ": " << line << std::endl;
+            continue;
+        }
+
+        regressionCase tc;
+        tc.name = in;
+        if (!makeCase(resolve(cfg), resolve(in), resolve(expected), tc)) {
+            std::cerr << "Error: Test case on manifest line " << lineNumber << " cannot be read" << std::endl;
+            ok = false;
+            continue;
+        }
+        cases.push_back(tc);
+    }
+    return ok;
+}
+
+regressionChecker::regressionChecker(const std::vector<regressionCase>& cases, int busBits)
+    : cases(cases), busLines(busBits < 128 ? 1 : busBits / 128) {
+    for (const regressionCase& tc : cases) {
+        totalBlocks += (long long)tc.configs.size();
+        for (const rmVectorRecord& rec : tc.configs) {
+            totalInBits += (long long)rec.codeBlocks() * rec.inlen;
+        }
+    }
+    startCase();
+}
+
+void regressionChecker::startCase() {
+    while (current < cases.size() && cases[current].configs.empty()) {
+        std::cout << "Regression: Case " << current + 1 << " (" << cases[current].name
+                  << "): FAIL, no transport blocks" << std::endl;
+        ++failed;
+        ++current;
+    }
+    beats = 0;
+    blocks = 0;
+    bitErrors = 0;
+    expected.clear();
+    if (current >= cases.size()) {
+        return;
+    }
+
+    // Expected output lines, or the beats of every record of a vector file
+    const std::string& path = cases[current].expectedPath;
+    checked = !path.empty();
+    if (!checked) {
+        return;
+    }
+    if (isVectorFile(path)) {
+        rmVectorReader reader;
+        rmVectorRecord rec;
+        if (reader.open(path)) {
+            while (reader.next(rec)) {
+                size_t at = expected.size();
+                expected.resize(at + 2 * (size_t)rec.beats);
+                reader.read(expected.data() + at, (int)rec.beats);
+            }
+        }
+    }
+    else {
+        rmReadTextLines(path, expected);
+    }
+    if (busLines > 1) {
+        padTransportBlocks(cases[current]);
+    }
+}
+
+void regressionChecker::padTransportBlocks(const regressionCase& tc) {
+    std::vector<uint64_t> padded;
+    size_t line = 0, lines = expected.size() / 2;
+    for (const rmVectorRecord& rec : tc.configs) {
+        // Output bits of the transport block, as the DUT concatenates its code blocks
+        int C = rec.codeBlocks();
+        int G = rec.tbOutputBits();
+        long long bits = 0;
+        for (int r = 0; r < C; ++r) {
+            bits += rmBlockE(G, C, r, rec.nlayers, rec.Qm);
+        }
+        size_t tbLines = (size_t)((bits + 127) / 128);
+        size_t paddedLines = (tbLines + busLines - 1) / busLines * busLines;
+
+        size_t n = std::min(tbLines, lines - line);
+        padded.insert(padded.end(), expected.begin() + 2 * line, expected.begin() + 2 * (line + n));
+        padded.resize(padded.size() + 2 * (paddedLines - n), 0);
+        line += n;
+    }
+
+    // Anything the configurations do not account for is kept, it fails the case
+    padded.insert(padded.end(), expected.begin() + 2 * line, expected.end());
+    expected.swap(padded);
+}
+
+void regressionChecker::beat(uint64_t hi, uint64_t lo) {
+    if (done()) {
+        return;
+    }
+    if (checked) {
+        size_t w = 2 * beats;
+        if (w + 1 < expected.size()) {
+            uint64_t got[2] = { hi, lo };
+            bitErrors += checkError(got, expected.data() + w, 2);
+        }
+    }
+    ++beats;
+    ++outBeats;
+}
+
+void regressionChecker::endTransportBlock() {
+    if (done()) {
+        return;
+    }
+    if (++blocks == cases[current].configs.size()) {
+        finishCase();
+        ++current;
+        startCase();
+    }
+}
+
+void regressionChecker::finishCase() {
+    const regressionCase& tc = cases[current];
+    std::cout << "Regression: Case " << current + 1 << " (" << tc.name << "): ";
+    if (!checked) {
+        std::cout << "DONE, not checked, " << beats << " beats" << std::endl;
+        ++unchecked;
+        return;
+    }
+
+    size_t expectedBeats = expected.size() / 2;
+    if (bitErrors == 0 && beats == expectedBeats) {
+        std::cout << "PASS, " << blocks << " transport blocks, " << beats << " beats" << std::endl;
+        ++passed;
+    }
+    else {
+        std::cout << "FAIL, " << bitErrors << " bit errors, " << beats << " of " << expectedBeats
+                  << " beats" << std::endl;
+        ++failed;
+    }
+}
+
+void regressionChecker::report(double wallSeconds) const {
+    size_t incomplete = cases.size() - std::min(current, cases.size());
+    std::cout << "Regression: " << cases.size() << " cases, " << passed << " passed, " << failed << " failed";
+    if (unchecked > 0) {
+        std::cout << ", " << unchecked << " not checked";
+    }
+    if (incomplete > 0) {
+        std::cout << ", " << incomplete << " not finished";
+    }
+    std::cout << std::endl;
+
+    long long outBits = outBeats * 128;
+    std::cout << "Regression: " << totalBlocks << " transport blocks, " << totalInBits << " input bits, "
+              << outBits << " output bits in " << wallSeconds << " s";
+    if (wallSeconds > 0) {
+        std::cout << " (" << totalInBits / wallSeconds / 1e6 << " Mbit/s in, "
+                  << outBits / wallSeconds / 1e6 << " Mbit/s out)";
+    }
+    std::cout << std::endl;
+}
@@ -0,0 +1,81 @@
+// Regression.h
+
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "rmVector.h"
+
+// One test case of a regression run
+struct regressionCase {
+    std::string name;                      // As written in the manifest, for the report
+    std::string cfgPath;                   // Configuration text file, empty for a vector file input
+    std::string inPath;                    // 128-bit input lines, or a vector file (.rmv)
+    std::string expectedPath;              // Expected output lines or vector file, empty = not checked
+    std::vector<rmVectorRecord> configs;   // One per transport block
+};
+
+// True for a binary vector file (.rmv)
+bool isVectorFile(const std::string& path);
+
+// Make a test case from its files and load its configurations.
+// Returns false if the configuration or the vector file cannot be read.
+bool makeCase(const std::string& cfgPath, const std::string& inPath, const std::string& expectedPath,
+              regressionCase& tc);
+
+// Read a manifest of test cases, one per line: "config input expected".
+// Paths are relative to the manifest; "-" stands for no configuration file
+// (the input is a vector file) or no expected output. Blank lines and lines
+// starting with '#' are skipped.
+bool readManifest(const std::string& path, std::vector<regressionCase>& cases);
+
+// Compares the output beats with the expected output of each test case as
+// they arrive and prints the result of every case once its last transport
+// block has been received
+class regressionChecker {
+public:
+    // busBits is the width of the DUT output, a multiple of 128. The expected
+    // output of each transport block is then zero-padded to whole bus words.
+    explicit regressionChecker(const std::vector<regressionCase>& cases, int busBits = 128);
+
+    // Next 128-bit line of the output, and the end of a transport block (dout_last)
+    void beat(uint64_t hi, uint64_t lo);
+    void endTransportBlock();
+
+    bool done() const { return current >= cases.size(); }
+    int failures() const { return failed; }
+
+    // Transport blocks of all test cases
+    long long transportBlocks() const { return totalBlocks; }
+
+    // Print the aggregate result, wallSeconds is the host time of the run
+    void report(double wallSeconds) const;
+
+private:
+    const std::vector<regressionCase>& cases;
+    const int busLines;                // 128-bit lines per output bus word
+    long long totalBlocks = 0;
+    long long totalInBits = 0;
+
+    // Current test case
+    size_t current = 0;
+    bool checked = false;              // Has an expected output
+    std::vector<uint64_t> expected;    // Expected beats, two words each
+    size_t beats = 0;                  // Beats received
+    size_t blocks = 0;                 // Transport blocks received
+    long long bitErrors = 0;
+
+    int passed = 0, failed = 0, unchecked = 0;
+    long long outBeats = 0;
+
+    // Load the expected output of the current case, skipping cases without transport blocks
+    void startCase();
+
+    // Pad each transport block of the expected output to whole bus words
+    void padTransportBlocks(const regressionCase& tc);
+    void finishCase();
+};
+
+#endif // REGRESSION_H
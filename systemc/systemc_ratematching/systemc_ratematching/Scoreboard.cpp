@@ -0,0 +1,192 @@
+/*
+ * ==============================================
+ * File:        Scoreboard.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Testbench scoreboard. Builds the expected
+ *              output of each code block with the C++
+ *              reference of nrRateMatchLDPC_modify from the
+ *              configuration and input beats the DUT took, and
+ *              compares every output beat as it arrives.
+ * ==============================================
+ */
+
+#include "Scoreboard.h"
+#include "rmReference.h"
+#include "myLibrary.h"
+#include <algorithm>
+#include <iostream>
+
+void scoreboard::config(const ratematchingConfig& cfg) {
+    configs.push_back(cfg);
+    replayStored();
+}
+
+void scoreboard::storedInput() {
+    ++storedInputs;
+    replayStored();
+}
+
+void scoreboard::inputBeat(const uint64_t* beat) {
+    if (configs.empty() || storedInputs != 0) {
+        std::cerr << "Scoreboard: Input beat without a configuration" << std::endl;
+        return;
+    }
+    takeBeat(beat);
+    replayStored();
+}
+
+void scoreboard::takeBeat(const uint64_t* beat) {
+    inWords.insert(inWords.end(), beat, beat + inWidth / 64);
+    tbWords.insert(tbWords.end(), beat, beat + inWidth / 64);
+
+    // Each code block is padded to whole beats
+    ratematchingConfig cfg = configs.front();
+    int C = cfg.codeBlocks();
+    size_t blockBeats = ((int)cfg.inlen + inWidth - 1) / inWidth;
+    if (inWords.size() < blockBeats * (inWidth / 64)) {
+        return;
+    }
+    expectBlock(cfg, C);
+    inWords.clear();
+
+    if (++block == C) {
+        // The input is kept for a retransmission of the same HARQ process
+        harqInput[cfg.harqId].swap(tbWords);
+        tbWords.clear();
+        packBeats(true);
+        configs.pop_front();
+        block = 0;
+        tbChecked = true;
+        ++tbIn;
+    }
+    else {
+        packBeats(false);
+    }
+    compare();
+}
+
+void scoreboard::replayStored() {
+    // Once its configuration is known and the transport blocks ahead of it are complete
+    while (storedInputs != 0 && !configs.empty() && block == 0 && inWords.empty()) {
+        const ratematchingConfig& cfg = configs.front();
+        --storedInputs;
+        int C = cfg.codeBlocks();
+        size_t words = (size_t)C * (((int)cfg.inlen + inWidth - 1) / inWidth) * (inWidth / 64);
+        std::vector<uint64_t> input = harqInput[cfg.harqId];
+        if (input.size() != words) {
+            std::cerr << "Scoreboard: No input of HARQ process " << cfg.harqId << " for transport block " << tbIn
+                      << std::endl;
+            ++mismatchBeats;
+            configs.pop_front();
+            continue;
+        }
+        ++tbStored;
+        for (size_t i = 0; i < words; i += inWidth / 64) {
+            takeBeat(&input[i]);
+        }
+    }
+}
+
+void scoreboard::expectBlock(const ratematchingConfig& cfg, int C) {
+    int N = cfg.inlen;
+
+    int E = rmRefBlockE(cfg.tbOutputBits(), C, block, cfg.nlayers, cfg.Qm);
+
+    // The MATLAB code rejects other lengths, the DUT output is then only counted
+    if (!rmRefLegalLength(N)) {
+        tbChecked = false;
+        outBits.resize(outBits.size() + E, 0);
+        return;
+    }
+
+    // Unpack the code block to one element per bit, with the filler bits as -1
+    std::vector<int8_t> d(N);
+    for (int i = 0; i < N; ++i) {
+        d[i] = (int8_t)((inWords[i >> 6] >> (63 - (i & 63))) & 1);
+    }
+    rmRefMarkFillers(d, cfg.F);
+
+    std::vector<int8_t> e = rmRefRateMatchLDPC(d, E, cfg.rv, cfg.Qm, cfg.nlayers, cfg.Nref);
+    outBits.insert(outBits.end(), e.begin(), e.end());
+}
+
+void scoreboard::packBeats(bool final) {
+    // A transport block's code blocks are concatenated, so a beat can span two of them
+    size_t pos = 0;
+    while (pos < outBits.size() && (final || outBits.size() - pos > (size_t)outWidth)) {
+        beat b = { std::vector<uint64_t>(outWidth / 64, 0), false, tbChecked, tbIn, outBeats++ };
+        for (int i = 0; i < outWidth && pos + i < outBits.size(); ++i) {
+            b.w[i >> 6] |= (uint64_t)(outBits[pos + i] & 1) << (63 - (i & 63));
+        }
+        pos += outWidth;
+        b.last = final && pos >= outBits.size();
+        expected.push_back(std::move(b));
+    }
+    outBits.erase(outBits.begin(), outBits.begin() + std::min(pos, outBits.size()));
+    if (final) {
+        outBeats = 0;
+    }
+}
+
+void scoreboard::outputBeat(const uint64_t* data, bool last) {
+    beat b = { std::vector<uint64_t>(data, data + outWidth / 64), last, true, 0, 0 };
+    received.push_back(std::move(b));
+    compare();
+}
+
+void scoreboard::compare() {
+    while (!expected.empty() && !received.empty()) {
+        beat e = std::move(expected.front());
+        beat r = std::move(received.front());
+        expected.pop_front();
+        received.pop_front();
+
+        if (!e.checked) {
+            ++beatsUnchecked;
+            continue;
+        }
+        int errors = checkError(r.w.data(), e.w.data(), outWidth / 64);
+        ++beatsChecked;
+        if (errors == 0 && r.last == e.last) {
+            continue;
+        }
+
+        bitErrors += errors;
+        if (mismatchBeats++ == 0) {
+            std::cerr << "Scoreboard: First mismatch at " << sc_time_stamp() << ", transport block " << e.tb
+                      << ", beat " << e.index << ": " << errors << " bit errors";
+            if (r.last != e.last) {
+                std::cerr << ", dout_last " << r.last << " expected " << e.last;
+            }
+            std::cerr << std::endl;
+            if (onMismatch) {
+                onMismatch();
+            }
+            if (stopOnMismatch) {
+                sc_stop();
+            }
+        }
+    }
+}
+
+void scoreboard::report() const {
+    std::cout << "Scoreboard: " << tbIn << " transport blocks, " << beatsChecked << " beats checked, "
+              << mismatchBeats << " mismatching beats, " << bitErrors << " bit errors";
+    if (beatsUnchecked != 0) {
+        std::cout << ", " << beatsUnchecked << " beats of non-standard lengths not checked";
+    }
+    if (tbStored != 0) {
+        std::cout << ", " << tbStored << " transport blocks from the HARQ store";
+    }
+    if (!expected.empty()) {
+        std::cout << ", " << expected.size() << " beats not received";
+    }
+    if (!received.empty()) {
+        std::cout << ", " << received.size() << " unexpected beats";
+    }
+    std::cout << (passed() ? " - PASS" : " - FAIL") << std::endl;
+}
@@ -0,0 +1,100 @@
+// Scoreboard.h
+
+#ifndef SCOREBOARD_H
+#define SCOREBOARD_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+#include "ratematching.h"
+
+// Checks the DUT against the golden reference (rmReference.h) while the
+// simulation runs. The source reports every configuration and input beat the
+// DUT accepts, the expected output of each code block is computed as soon as
+// its input is complete, and the sink reports every output beat, which is
+// compared with checkError once its expected value is known. A HARQ
+// retransmission the DUT takes from its store is checked against the last
+// input of the same process.
+class scoreboard {
+public:
+    // Bus widths in bits of the DUT input and output, multiples of 64
+    explicit scoreboard(int inBits = sizePort, int outBits = sizePort)
+        : inWidth(inBits), outWidth(outBits) {}
+
+    // Stop the simulation at the first mismatching beat
+    void setStopOnMismatch(bool stop) { stopOnMismatch = stop; }
+
+    // Called at the first mismatching beat, e.g. to trigger the wave tracer
+    void setOnMismatch(std::function<void()> f) { onMismatch = f; }
+
+    // A configuration taken by the DUT, in order
+    void config(const ratematchingConfig& cfg);
+
+    // The DUT takes the code blocks of the next transport block without input
+    // beats from its HARQ store: the last input of the same process
+    void storedInput();
+
+    // An input beat taken by the DUT, inBits / 64 words with the first 64 bits in beat[0]
+    void inputBeat(const uint64_t* beat);
+
+    // An output beat taken from the DUT, outBits / 64 words
+    void outputBeat(const uint64_t* beat, bool last);
+
+    // No mismatching beat, and every expected beat received and no other
+    bool passed() const { return mismatchBeats == 0 && expected.empty() && received.empty(); }
+
+    // Print the beats checked and the mismatch counts
+    void report() const;
+
+private:
+    struct beat {
+        std::vector<uint64_t> w;
+        bool last;
+        bool checked;                   // False when the reference cannot compute it
+        long long tb;                   // Transport block index
+        int index;                      // Beat index in the transport block
+    };
+
+    const int inWidth, outWidth;
+    bool stopOnMismatch = false;
+    std::function<void()> onMismatch;
+
+    std::deque<ratematchingConfig> configs;   // Waiting for their input beats
+    int storedInputs = 0;                     // Transport blocks to take from harqInput
+    std::vector<uint64_t> inWords;            // Input of the current code block
+    std::vector<uint64_t> tbWords;            // Input of the current transport block
+    std::map<int, std::vector<uint64_t>> harqInput;  // Last transport block input of each HARQ process
+    int block = 0;                            // Current code block of the first configuration
+    std::vector<int8_t> outBits;              // Expected bits not yet packed into a beat
+    int outBeats = 0;                         // Expected beats of the transport block so far
+    bool tbChecked = true;                    // Every code block of the transport block has a reference
+
+    std::deque<beat> expected;                // Expected beats not yet received
+    std::deque<beat> received;                // Received beats not yet expected
+
+    long long tbIn = 0;                       // Transport blocks with their input complete
+    long long tbStored = 0;                   // Of which retransmitted from the DUT's HARQ store
+    long long beatsChecked = 0;
+    long long beatsUnchecked = 0;
+    long long mismatchBeats = 0;
+    long long bitErrors = 0;
+
+    // Add an input beat to the first configuration
+    void takeBeat(const uint64_t* beat);
+
+    // Feed the stored input of the transport blocks reported by storedInput
+    void replayStored();
+
+    // Expected output of the current code block, from inWords
+    void expectBlock(const ratematchingConfig& cfg, int C);
+
+    // Pack outBits into expected beats, the last one zero-padded when final
+    void packBeats(bool final);
+
+    // Compare received beats with expected ones while both are there
+    void compare();
+};
+
+#endif // SCOREBOARD_H
@@ -19,57 +19,108 @@
 
  /***************Include files**************/
 #include "sink.h"
+#include "rmVector.h"
+#include "Log.h"
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
 
 
-void sink::sink_thread() {
+template <int WIDTH, int BEATS>
+bool sink<WIDTH, BEATS>::readyPattern(long long cycle) {
+    if (bpStall == 0) {
+        return true;
+    }
+    if (bpRandom) {
+        return (long long)(bpRng() % (unsigned)(bpReady + bpStall)) >= bpStall;
+    }
+    return cycle % (bpReady + bpStall) < bpReady;
+}
+
+template <int WIDTH, int BEATS>
+void sink<WIDTH, BEATS>::sink_thread() {
 
     /****** Open file ******/
-    std::string outputFilePath = "C:/Users/ADMIN/Desktop/Project_Ratematching/io/output/output_data2.txt";
-    std::ofstream outputFile;
-    outputFile.open(outputFilePath);
-    if (!outputFile.is_open()) {
+    rmBeatWriter outputFile;
+    if (!outputFilePath.empty() && !outputFile.open(outputFilePath)) {
         std::cerr << "Error: Failed to open output file: " << outputFilePath << std::endl;
     }
 
 
     int dataCount = 0;
+    int blockCount = 0;
+    long long cycle = 0;
     while (true) {
         wait(); // Wait for clock edge
 
         if (rst.read()) {
             din_ready.write(false);
             dataCount = 0;
-            std::cout << "Sink: Reset signal received." << std::endl;
+            blockCount = 0;
+            RM_LOG(SC_MEDIUM, name(), "Reset signal received");
             continue;
         }
 
-        // Indicate that the Sink is ready to receive data
-        din_ready.write(true);
+        // Data is taken on the edge where din_valid and din_ready are both high
+        bool taken = din_valid.read() && din_ready.read();
+        inStats.sample(din_valid.read(), din_ready.read());
+
+        // Indicate whether the Sink is ready to receive data next cycle
+        din_ready.write(readyPattern(cycle++));
 
         // Check if valid data is received
-        if (din_valid.read()) {
-            sc_lv<128> received_data = din_data.read();
-            std::cout << "Sink : Received dataCount [" << dataCount << "]:" << received_data << std::endl;
-            outputFile << received_data << std::endl;
+        if (taken) {
+            const sc_lv<IN_WIDTH>& received_data = din_data.read();
+            uint64_t words[IN_WIDTH / 64];
+            lvToWords(received_data, words);
+            RM_LOG(SC_DEBUG, name(), "Received dataCount [" << dataCount << "]: " << received_data);
+
+            // Files and expected outputs are in 128-bit lines
+            for (int w = 0; w < IN_WIDTH / 64; w += 2) {
+                if (outputFile.isOpen()) {
+                    outputFile.write(words[w], words[w + 1]);
+                }
+                if (checker != nullptr) {
+                    checker->beat(words[w], words[w + 1]);
+                }
+            }
+            if (board != nullptr) {
+                board->outputBeat(words, din_last.read());
+            }
             dataCount++;
             //std::cout << "\n***************Sink: Data received and processed. (dataCount: " << dataCount << ")***************\n" << std::endl;
             
-            // Check if it's the last data
+            // Check if it's the last data of a transport block
             if (din_last.read()) {
-                std::cout << "Sink: Last data received. Total received: " << dataCount << " data counts." << std::endl;
+                outputFile.endTransportBlock();
+                if (checker != nullptr) {
+                    checker->endTransportBlock();
+                }
+            }
+            if (din_last.read() && ++blockCount == numTransportBlocks) {
+                RM_LOG(SC_MEDIUM, name(), "Last data received. Total received: " << dataCount << " data counts");
                 din_ready.write(false);  // No more data to receive
-                //break;  // Exit the loop since all data has been received
+                break;  // Exit the loop since every transport block has been received
             }
         }
-        else {
-            std::cout << "Sink: Waiting for valid data." << std::endl;
+        else if (!din_valid.read()) {
+            RM_LOG(SC_DEBUG, name(), "Waiting for valid data");
         }
     }
 
     outputFile.close(); // Close the file after processing is complete
-    sc_stop();
+    while (inputDone && !inputDone()) {
+        wait();
+    }
+    if (onDone) {
+        onDone();
+    }
+    else {
+        sc_stop();
+    }
 }
+
+// Bus configurations selectable from sc_main
+#define RM_INSTANTIATE(W, B) template class sink<W, B>;
+RM_BUS_CONFIGS(RM_INSTANTIATE)
+#undef RM_INSTANTIATE
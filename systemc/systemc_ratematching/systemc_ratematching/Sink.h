@@ -2,11 +2,22 @@
 #define SINK_H
 
 #include <systemc.h>
+#include <functional>
+#include <random>
+#include <string>
+#include "ratematching.h"
+#include "Regression.h"
+#include "Scoreboard.h"
+#include "rmStats.h"
 
-SC_MODULE(sink) {
+// Receives BEATS beats of WIDTH bits per cycle from RateMatching
+template <int WIDTH = sizePort, int BEATS = 1>
+class sink : public sc_module {
 public:
+    static const int IN_WIDTH = WIDTH * BEATS;
+
     sc_in<bool>         din_valid;     // Valid signal from RateMatching
-    sc_in<sc_lv<128>>   din_data;   // 128-bit input data
+    sc_in<sc_lv<IN_WIDTH>> din_data;   // Input data
     sc_in<bool>         din_last;   // Last signal from RateMatching
     sc_out<bool>        din_ready;   // Ready signal to RateMatching
 
@@ -14,13 +25,66 @@ public:
     sc_in<bool> rst;          // Reset
 
     // Constructor
-    SC_CTOR(sink) {
+    SC_HAS_PROCESS(sink);
+    explicit sink(sc_module_name name) : sc_module(name) {
         SC_THREAD(sink_thread);
         sensitive << clk.pos();
         async_reset_signal_is(rst, true);
     }
 
+    // Downstream stall model: din_ready is high for readyCycles then low for
+    // stallCycles, repeating. With a non-zero seed each cycle is instead
+    // stalled at random with probability stallCycles / (readyCycles + stallCycles).
+    void setBackpressure(int readyCycles, int stallCycles, unsigned seed = 0) {
+        bpReady = readyCycles < 1 ? 1 : readyCycles;
+        bpStall = stallCycles < 0 ? 0 : stallCycles;
+        bpRandom = (seed != 0);
+        bpRng.seed(seed);
+    }
+
+    // Number of transport blocks (dout_last beats) to receive before stopping
+    void setTransportBlocks(int n) { numTransportBlocks = n < 1 ? 1 : n; }
+
+    // Output file, 128-bit text lines or a vector file when it ends in ".rmv",
+    // each received word as IN_WIDTH / 128 lines. Nothing is written when it is empty.
+    void setOutputFile(const std::string& path) { outputFilePath = path; }
+
+    // Check every received beat against the expected output of the test cases
+    void setChecker(regressionChecker* c) { checker = c; }
+
+    // Report every received beat to the scoreboard
+    void setScoreboard(scoreboard* s) { board = s; }
+
+    // Called once the last transport block has been received, instead of stopping the simulation
+    void setOnDone(std::function<void()> f) { onDone = f; }
+
+    // True once the input side has sent everything. In cut-through mode the output of
+    // the last transport block can be complete before the tail of its input is taken,
+    // which the sink then waits for.
+    void setInputDone(std::function<bool()> f) { inputDone = f; }
+
+    // Add the din handshake counters to a report
+    void writeStats(rmStatsReport& report) const { report.add(name(), "din", inStats); }
+
+    // din handshake counters
+    const rmStreamStats& inputStats() const { return inStats; }
+
 private:
+    std::string outputFilePath;
+    regressionChecker* checker = nullptr;
+    scoreboard* board = nullptr;
+    std::function<void()> onDone;
+    std::function<bool()> inputDone;
+    rmStreamStats inStats;
+    int numTransportBlocks = 1;
+    int bpReady = 1;
+    int bpStall = 0;
+    bool bpRandom = false;
+    std::mt19937 bpRng;
+
+    // din_ready for the given cycle of the stall pattern
+    bool readyPattern(long long cycle);
+
     void sink_thread();
 };
 
@@ -18,185 +18,221 @@
  */
 #include "ratematching.h"
 #include "source.h"
+#include "Log.h"
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string>
-#include <sstream>
+#include <algorithm>
 
-void source::source_thread() {
+ratematchingConfig toRatematchingConfig(const rmVectorRecord& rec) {
+    ratematchingConfig config;
+    config.inlen = rec.inlen;
+    config.outlen = rec.outlen;
+    config.rv = rec.rv;
+    config.nlayers = rec.nlayers;
+    config.Qm = rec.Qm;
+    config.Nref = rec.Nref;
+    config.C = rec.C;
+    config.G = rec.G;
+    config.F = rec.F;
+    return config;
+}
+
+template <int WIDTH>
+void source<WIDTH>::config_thread() {
 
     // Initial conditions
-    // ================================
-    dout_data.write(sc_lv<128>("0"));  // Initialize dout_data to 0
-    dout_valid.write(false);           // Initialize dout_valid to false
-    dout_last.write(false);             // Initialize dout_last to false
     config_data.write(sc_lv<CFG_WIDTH>("0"));  // Initialize config_data to 0
     config_valid.write(false);         // Initialize config_valid to false
 
-    // Files
-    /*std::string cfgFilePath = "../../io/input/config_inputdata1.txt";
-    std::string inputFilePath = "../../io/input/input_data1.txt";*/
-
-    std::string cfgFilePath = "C:/Users/ADMIN/Desktop/Project_Ratematching/io/input/config_inputdata2.txt";
-    std::string inputFilePath = "C:/Users/ADMIN/Desktop/Project_Ratematching/io/input/input_data2.txt";
-
-
     /////////////////////////////////////
     /****** Sending configuration ******/
     /////////////////////////////////////
-    std::ifstream file(cfgFilePath);
-    if (!file.is_open())
-    {
-        std::cerr << "Error: Could not open file " << cfgFilePath << std::endl;
-        sc_stop();
-    }
-
-    ratematchingConfig config;
+    size_t cfgCount = 0;
+    while (cfgCount < configs.size()) {
 
-    std::string line;
-    while (std::getline(file, line))
-    {
-        std::istringstream iss(line);
-        std::string key;
-        int value;
-
-        if (std::getline(iss, key, ':') && iss >> value)
-        {
-            // Remove whitespace
-            key.erase(remove(key.begin(), key.end(), ' '), key.end());
-
-            if (key == "input_length")
-            {
-                config.inlen = value;
-            }
-            else if (key == "output_length")
-            {
-                config.outlen = value;
-            }
-            else if (key == "redundancy_version")
-            {
-                config.rv = value;
-            }
-            else if (key == "layer")
-            {
-                config.nlayers = value;
-            }
-            else if (key == "modulation_type")
-            {
-                config.Qm = value;
-            }
-            else if (key == "Nref")
-            {
-                config.Nref = value;
-            }
-            else
-            {
-                std::cerr << "Warning: Unrecognized key in config file: " << key << std::endl;
-            }
+        // Check if reset signal is active
+        if (rst.read()) {
+            config_valid.write(false);
+            cfgCount = 0;
+            wait();
+            continue;
         }
-        else
-        {
-            std::cerr << "Warning: Incorrect format in line: " << line << std::endl;
+
+        const ratematchingConfig& config = configs[cfgCount];
+        config_data.write(toConfigData(config));
+        config_valid.write(true);
+
+        // The configuration is taken on the first clock edge that sees config_ready high
+        do {
+            wait();
+        } while (!config_ready.read());
+        if (board != nullptr) {
+            board->config(config);
         }
+        ++cfgCount;
     }
 
-    file.close();
-
-    sc_lv<CFG_WIDTH> configData;
-    configData.range(15, 0) = config.inlen;
-    configData.range(31, 16) = config.outlen;
-    configData.range(33, 32) = config.rv;
-    configData.range(36, 34) = config.nlayers;
-    configData.range(40, 37) = config.Qm;
-    configData.range(46, 41) = config.Nref;
+    config_valid.write(false);
+}
 
-    config_data.write(configData);
-    config_valid.write(true);
+template <int WIDTH>
+bool source<WIDTH>::sendBeat(const uint64_t* beat, bool last) {
 
-    while (!config_ready.read()) {
+    // Check if reset signal is active
+    if (rst.read()) {
+        dout_valid.write(false);
+        dout_last.write(false);
+        RM_LOG(SC_MEDIUM, name(), "Reset signal received");
         wait();
+        return false;
     }
 
-    config_valid.write(false);
-    wait();
+    sc_lv<WIDTH> data;
+    wordsToLv(beat, data);
+    dout_data.write(data);
+    dout_valid.write(true); // Indicate valid data
+    dout_last.write(last);
 
-    /////////////////////////////////////
-    /****** Sending input data    ******/
-    /////////////////////////////////////
-    std::ifstream inputFile(inputFilePath);
-    if (!inputFile.is_open()) {
-        std::cerr << "Error: Could not open file " << inputFilePath << std::endl;
-        sc_stop();
+    // The beat is taken on the first clock edge that sees dout_ready high
+    do {
+        wait();
+        outStats.sample(true, dout_ready.read());
+    } while (!dout_ready.read());
+    if (board != nullptr) {
+        board->inputBeat(beat);
     }
-    std::vector<sc_lv<128>> dataBuffer;
+    return true;
+}
 
-    // Read lines from the file and store them in dataBuffer
-    while (std::getline(inputFile, line)) {
-        if (line.length() == 128) {
-            dataBuffer.push_back(sc_lv<128>(line.c_str()));
+template <int WIDTH>
+bool source<WIDTH>::sendLine(uint64_t hi, uint64_t lo, bool blockEnd) {
+    beatWords[2 * beatLines] = hi;
+    beatWords[2 * beatLines + 1] = lo;
+    if (++beatLines < WIDTH / 128 && !blockEnd) {
+        return true;
+    }
+
+    // A code block starts on a new beat, the padding of its last beat is zero
+    std::fill(beatWords + 2 * beatLines, beatWords + WIDTH / 64, 0);
+    beatLines = 0;
+    return sendBeat(beatWords, blockEnd);
+}
+
+template <int WIDTH>
+void source<WIDTH>::sendLines(const regressionCase& tc) {
+
+    dataWords.clear();
+    rmReadTextLines(tc.inPath, dataWords);
+
+    // The input file holds the code blocks of each transport block back to back,
+    // each padded to whole 128-bit lines
+    int numLines = (int)(dataWords.size() / 2);
+    std::vector<int> lastLine(numLines, 0);
+    int line = 0;
+    for (const rmVectorRecord& config : tc.configs) {
+        int blockLines = ((int)config.inlen + 127) / 128;
+        int C = config.codeBlocks();
+        if (blockLines == 0) {
+            blockLines = numLines;
         }
-        else {
-            std::cerr << "Warning: Skipping line with invalid length: " << line.length() << std::endl;
+        for (int r = 0; r < C && line < numLines; ++r) {
+            line += blockLines;
+            lastLine[std::min(line, numLines) - 1] = 1;
         }
     }
+    if (numLines != 0) {
+        lastLine.back() = 1;
+    }
 
-    inputFile.close(); // Close the file after reading
-
-    /***** Send data to FIFO ******/
-    
     int dataCount = 0;           // Reset data counter
-    std::cout << "Source: Sending data to RateMatching dataCount [" << dataCount << "]" << std::endl; // Print datacout
-    sc_lv<128> data = dataBuffer[dataCount];
-    //std::cout << "Source: Sending data to RateMatching: " << data << std::endl;
-
-    dout_data.write(data);
-    dout_valid.write(true);   // Indicate valid data
-    dataCount = dataCount + 1;
 
-    // Main loop to send data to FIFO
-    while (true) {
+    // Main loop to send data to FIFO, one beat per cycle while dout_ready is high
+    while (dataCount < numLines) {
 
-        std::cout << std::endl;
-        if (dataCount >= (int)dataBuffer.size())
-        {
-            break;
-        }
+        RM_LOG(SC_DEBUG, name(), "Sending data to RateMatching (dataCount: " << dataCount << ")");
 
-        // Check if reset signal is active
-        if (rst.read()) {
-            dout_valid.write(false);
-            dout_last.write(false);
-            std::cout << "Source: Reset signal received." << std::endl;
+        // Assert out_last on the last data word of each code block
+        if (!sendLine(dataWords[2 * dataCount], dataWords[2 * dataCount + 1], lastLine[dataCount] != 0)) {
             dataCount = 0;           // Reset data counter
             continue;                // Skip the rest of the loop
         }
+        ++dataCount;
+    }
+}
 
+template <int WIDTH>
+void source<WIDTH>::sendVectors(const regressionCase& tc) {
 
-        // Wait for FIFO to be ready
-        while (!dout_ready.read()) {
-            wait(); // Wait until the FIFO is ready to accept data
-        }
+    if (!vectors.open(tc.inPath)) {
+        return;
+    }
 
-        // Send data only when FIFO is ready
-        if (dout_ready.read()) {
-            sc_lv<128> data = dataBuffer[dataCount];
-            dout_data.write(data);
-            dout_valid.write(true); // Indicate valid data
-            //std::cout << "Source: Sending data to RateMatching: " << data << std::endl;
-            std::cout << "Source: Sending data to RateMatching (dataCount: " << dataCount << ")" << std::endl;
-            ++dataCount;
+    // Beats are read from the file a chunk at a time, so memory stays bounded
+    const int chunkBeats = 64;
+    uint64_t chunk[2 * chunkBeats];
 
-            // Assert out_last on last data word
-            dout_last.write(dataCount == (int)dataBuffer.size());
+    bool restart = true;
+    while (restart) {
+        restart = false;
+        vectors.rewind();
 
+        rmVectorRecord rec;
+        while (!restart && vectors.next(rec)) {
+            uint32_t blockLines = (rec.inlen + 127) / 128;
+            if (blockLines == 0) {
+                blockLines = rec.beats;
+            }
+
+            uint32_t beat = 0;
+            while (!restart && beat < rec.beats) {
+                int n = vectors.read(chunk, chunkBeats);
+                if (n == 0) {
+                    break;
+                }
+                for (int i = 0; i < n; ++i, ++beat) {
+                    // dout_last on the last beat of each code block
+                    bool last = (beat + 1) % blockLines == 0 || beat + 1 == rec.beats;
+                    if (!sendLine(chunk[2 * i], chunk[2 * i + 1], last)) {
+                        restart = true;
+                        break;
+                    }
+                }
+            }
         }
+    }
+    vectors.close();
+}
+
+template <int WIDTH>
+void source<WIDTH>::source_thread() {
+
+    // Initial conditions
+    // ================================
+    dout_data.write(sc_lv<WIDTH>("0"));  // Initialize dout_data to 0
+    dout_valid.write(false);           // Initialize dout_valid to false
+    dout_last.write(false);             // Initialize dout_last to false
 
-        wait(); // Wait for the next clock cycle
+    /***** Send data to FIFO ******/
+    for (const regressionCase& tc : cases) {
+        if (isVectorFile(tc.inPath)) {
+            sendVectors(tc);
+        }
+        else {
+            sendLines(tc);
+        }
     }
 
     // Signal that no more data will be sent
     dout_valid.write(false);
-    std::cout << "Source: No more data to send." << std::endl;
+    dout_last.write(false);
+    finished = true;
+    RM_LOG(SC_MEDIUM, name(), "No more data to send");
 
 }
+
+// Bus widths selectable from sc_main
+#define RM_INSTANTIATE(W) template class source<W>;
+RM_BUS_WIDTHS(RM_INSTANTIATE)
+#undef RM_INSTANTIATE
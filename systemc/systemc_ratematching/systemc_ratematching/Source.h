@@ -2,29 +2,90 @@
 #define SOURCE_H
 
 #include "ratematching.h"
+#include "rmVector.h"
+#include "Regression.h"
+#include "Scoreboard.h"
+#include "rmStats.h"
+#include <string>
+#include <vector>
 
-SC_MODULE(source) {
+// Configuration of a vector file record
+ratematchingConfig toRatematchingConfig(const rmVectorRecord& rec);
+
+// Sends the code blocks of the test cases, read as 128-bit lines, on a
+// WIDTH-bit bus: each code block is repacked into whole WIDTH-bit beats.
+template <int WIDTH = sizePort>
+class source : public sc_module {
 public:
     sc_in<bool>                 clk;            // Clock
     sc_in<bool>                 rst;            // Reset
 
-    sc_out<sc_lv<128>>          dout_data;    // 128-bit output data
+    sc_out<sc_lv<WIDTH>>        dout_data;    // Output data
     sc_out<bool>                dout_valid;   // Valid signal from Source
     sc_out<bool>                dout_last;
     sc_in<bool>                 dout_ready;   // Ready signal from RateMatching
 
-    sc_out<sc_lv<CFG_WIDTH>>    config_data;    // 47-bit configuration data
+    sc_out<sc_lv<CFG_WIDTH>>    config_data;    // Configuration data, CFG_WIDTH bits
     sc_out<bool>                config_valid;   // Valid signal to RateMatching
     sc_in<bool>                 config_ready;   // Ready signal from RateMatching
 
-    // Constructor
-    SC_CTOR(source) {
+    // Constructor, sends the transport blocks of the test cases in order.
+    // The cases must outlive the module.
+    SC_HAS_PROCESS(source);
+    source(sc_module_name name, const std::vector<regressionCase>& cases) : sc_module(name), cases(cases) {
+        for (const regressionCase& tc : cases) {
+            for (const rmVectorRecord& rec : tc.configs) {
+                configs.push_back(toRatematchingConfig(rec));
+            }
+        }
+
+        SC_THREAD(config_thread);
+        sensitive << clk.pos();
+        async_reset_signal_is(rst, true);
+
         SC_THREAD(source_thread);
         sensitive << clk.pos();
         async_reset_signal_is(rst, true);
     }
 
+    // Number of transport blocks (configurations) that will be sent
+    int transportBlocks() const { return (int)configs.size(); }
+
+    // Report every configuration and input beat taken by the DUT
+    void setScoreboard(scoreboard* s) { board = s; }
+
+    // Add the dout handshake counters to a report
+    void writeStats(rmStatsReport& report) const { report.add(name(), "dout", outStats); }
+
+    // Every input beat has been taken
+    bool done() const { return finished; }
+
 private:
+    const std::vector<regressionCase>& cases;
+    std::vector<ratematchingConfig> configs;   // One per transport block of all cases, in order
+    std::vector<uint64_t> dataWords;           // Input lines of the current case, two words each
+    rmVectorReader vectors;                    // Input of the current case when it is a vector file
+    scoreboard* board = nullptr;
+    rmStreamStats outStats;                    // dout handshakes while a beat is driven
+    uint64_t beatWords[WIDTH / 64] = {};       // Beat being filled from the input lines
+    int beatLines = 0;                         // Lines in beatWords
+    bool finished = false;
+
+    // Drive one beat and wait until it is taken, false on reset
+    bool sendBeat(const uint64_t* beat, bool last);
+
+    // Add one input line to the beat, which is sent once full or at the end
+    // of the code block, zero-padded. False on reset, the beat is dropped.
+    bool sendLine(uint64_t hi, uint64_t lo, bool blockEnd);
+
+    // Send the input lines of a case, or stream the records of its vector file
+    void sendLines(const regressionCase& tc);
+    void sendVectors(const regressionCase& tc);
+
+    // Sends the configurations back to back, ahead of their data
+    void config_thread();
+
+    // Sends the code blocks
     void source_thread();
 };
 
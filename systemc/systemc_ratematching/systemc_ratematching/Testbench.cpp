@@ -0,0 +1,190 @@
+/*
+ * ==============================================
+ * File:        Testbench.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Cycle-accurate testbench of one bus
+ *              configuration: connects the source or the
+ *              random generator, the rate matching module
+ *              and the sink on WIDTH-bit input and
+ *              WIDTH x BEATS bit output buses, so sc_main can
+ *              pick the widths at run time. The DUT is a single
+ *              rate matching module or a cluster of lanes.
+ * ==============================================
+ */
+
+#include "Testbench.h"
+#include "source.h"
+#include "sink.h"
+#include "RatematchingCluster.h"
+
+template <int WIDTH, int BEATS>
+class busTestbench : public testbench {
+public:
+    busTestbench(const std::string& suffix, sc_clock& clk, sc_signal<bool>& rst,
+                 const std::vector<regressionCase>& cases, const testbenchOptions& options)
+        : testbench(WIDTH, WIDTH * BEATS), outputSink(("sink" + suffix).c_str()),
+          laneCount(options.lanes) {
+        board.setStopOnMismatch(options.stopOnMismatch);
+        scoreboard* boardPtr = options.useScoreboard ? &board : nullptr;
+        outputSink.setBackpressure(options.sinkReady, options.sinkStall, options.sinkSeed);
+        outputSink.setScoreboard(boardPtr);
+
+        // The source of the test cases or the random generator, both have the same ports
+        if (options.random) {
+            randomSource.reset(new generator<WIDTH>(("generator" + suffix).c_str(), options.constraints));
+            connect(*randomSource, clk, rst, boardPtr);
+            randomSource->harq_valid(harq_valid);
+            randomSource->harq_hit(harq_hit);
+            randomSource->harq_ready(harq_ready);
+            outputSink.setInputDone([this] { return randomSource->done(); });
+        }
+        else {
+            fileSource.reset(new source<WIDTH>(("source" + suffix).c_str(), cases));
+            connect(*fileSource, clk, rst, boardPtr);
+            outputSink.setInputDone([this] { return fileSource->done(); });
+        }
+
+        // Connect signals for RateMatching module, or the cluster of lanes in its place
+        std::string dutName = "ratematching" + suffix;
+        if (laneCount > 1) {
+            cluster.reset(new ratematchingCluster<WIDTH, BEATS>(dutName.c_str(), laneCount, options.outFifoDepth,
+                                                                 options.cfgFifoDepth));
+            connectDut(*cluster, clk, rst);
+            cluster->setCutThrough(options.cutThrough);
+            cluster->setHarqCapacity(options.harqCapacity);
+        }
+        else {
+            rate_matching.reset(new ratematching<WIDTH, BEATS>(dutName.c_str(), options.outFifoDepth,
+                                                               options.cfgFifoDepth));
+            connectDut(*rate_matching, clk, rst);
+            rate_matching->setCutThrough(options.cutThrough);
+            rate_matching->setHarqCapacity(options.harqCapacity);
+        }
+
+        // Connect signals for Sink module
+        outputSink.clk(clk);
+        outputSink.rst(rst);
+        outputSink.din_ready(dout_ready);
+        outputSink.din_valid(dout_valid);
+        outputSink.din_data(dout_data);
+        outputSink.din_last(dout_last);
+    }
+
+    void setOutput(const std::string& path, regressionChecker* checker) override {
+        outputSink.setOutputFile(path);
+        outputSink.setChecker(checker);
+    }
+
+    void setOnDone(std::function<void()> f) override { outputSink.setOnDone(f); }
+
+    void trace(waveTracer& tracer) override {
+        tracer.add(config_data, "cfg_data");
+        tracer.add(config_valid, "cfg_vld");
+        tracer.add(config_ready, "cfg_rdy");
+        tracer.add(din_data, "input_data");
+        tracer.add(din_valid, "input_vld");
+        tracer.add(din_ready, "input_rdy");
+        tracer.add(din_last, "input_last");
+        tracer.add(dout_data, "output_data");
+        tracer.add(dout_valid, "output_vld");
+        tracer.add(dout_ready, "output_rdy");
+        tracer.add(dout_last, "output_last");
+    }
+
+    void report() const override {
+        if (cluster) {
+            cluster->reportThroughput();
+        }
+        else {
+            rate_matching->reportThroughput();
+        }
+        if (randomSource) {
+            randomSource->reportCoverage();
+        }
+    }
+
+    void writeStats(rmStatsReport& report) const override {
+        if (randomSource) {
+            randomSource->writeStats(report);
+        }
+        else {
+            fileSource->writeStats(report);
+        }
+        if (cluster) {
+            cluster->writeStats(report);
+        }
+        else {
+            rate_matching->writeStats(report);
+        }
+        outputSink.writeStats(report);
+    }
+
+    const rmStreamStats& inputStats() const override {
+        return cluster ? cluster->inputStats() : rate_matching->inputStats();
+    }
+    const rmStreamStats& outputStats() const override {
+        return cluster ? cluster->outputStats() : rate_matching->outputStats();
+    }
+
+private:
+    sc_signal<sc_lv<WIDTH>> din_data;
+    sc_signal<sc_lv<WIDTH * BEATS>> dout_data;
+
+    sink<WIDTH, BEATS> outputSink;
+    const int laneCount;
+    std::unique_ptr<ratematching<WIDTH, BEATS>> rate_matching;
+    std::unique_ptr<ratematchingCluster<WIDTH, BEATS>> cluster;
+    std::unique_ptr<source<WIDTH>> fileSource;
+    std::unique_ptr<generator<WIDTH>> randomSource;
+
+    template <class D>
+    void connectDut(D& dut, sc_clock& clk, sc_signal<bool>& rst) {
+        dut.clk(clk);
+        dut.rst(rst);
+        dut.config_data(config_data);
+        dut.config_valid(config_valid);
+        dut.config_ready(config_ready);
+        dut.din_data(din_data);
+        dut.din_valid(din_valid);
+        dut.din_ready(din_ready);
+        dut.din_last(din_last);
+        dut.dout_data(dout_data);
+        dut.dout_valid(dout_valid);
+        dut.dout_ready(dout_ready);
+        dut.dout_last(dout_last);
+        dut.harq_valid(harq_valid);
+        dut.harq_hit(harq_hit);
+        dut.harq_ready(harq_ready);
+    }
+
+    template <class S>
+    void connect(S& stimulus, sc_clock& clk, sc_signal<bool>& rst, scoreboard* boardPtr) {
+        stimulus.clk(clk);
+        stimulus.rst(rst);
+        stimulus.config_data(config_data);
+        stimulus.config_valid(config_valid);
+        stimulus.config_ready(config_ready);
+        stimulus.dout_data(din_data);
+        stimulus.dout_valid(din_valid);
+        stimulus.dout_ready(din_ready);
+        stimulus.dout_last(din_last);
+        stimulus.setScoreboard(boardPtr);
+        outputSink.setTransportBlocks((int)stimulus.transportBlocks());
+    }
+};
+
+std::unique_ptr<testbench> makeTestbench(int width, int beats, const std::string& suffix, sc_clock& clk,
+                                         sc_signal<bool>& rst, const std::vector<regressionCase>& cases,
+                                         const testbenchOptions& options) {
+#define RM_MAKE_TESTBENCH(W, B) \
+    if (width == W && beats == B) { \
+        return std::unique_ptr<testbench>(new busTestbench<W, B>(suffix, clk, rst, cases, options)); \
+    }
+    RM_BUS_CONFIGS(RM_MAKE_TESTBENCH)
+#undef RM_MAKE_TESTBENCH
+    return nullptr;
+}
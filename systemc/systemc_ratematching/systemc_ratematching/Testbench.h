@@ -0,0 +1,80 @@
+// Testbench.h
+
+#ifndef TESTBENCH_H
+#define TESTBENCH_H
+
+#include <systemc.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "ratematching.h"
+#include "Generator.h"
+#include "Regression.h"
+#include "Scoreboard.h"
+#include "Tracer.h"
+#include "rmStats.h"
+
+// Settings shared by every cycle-accurate testbench of a run
+struct testbenchOptions {
+    int outFifoDepth = 2;                    // Output FIFO depth of the DUT in dout words
+    int cfgFifoDepth = 4;                    // Configurations queued ahead of their data
+    int lanes = 1;                           // More than 1: ratematchingCluster with that many lanes
+    bool cutThrough = false;                 // See ratematching::setCutThrough
+    long long harqCapacity = RM_HARQ_CAPACITY; // HARQ store of the DUT in bits, see ratematching::setHarqCapacity
+    int sinkReady = 1, sinkStall = 0;        // Sink stall pattern, see sink::setBackpressure
+    unsigned sinkSeed = 0;
+    bool random = false;                     // Generator instead of the source of the test cases
+    generatorConstraints constraints;
+    bool useScoreboard = true;
+    bool stopOnMismatch = false;
+};
+
+// Signals, stimulus, DUT, sink and scoreboard of one cycle-accurate run. The
+// modules are templates on the bus width and the output beats per cycle, this
+// is the part of the testbench that does not depend on them.
+class testbench {
+public:
+    // Handshakes and configuration bus
+    sc_signal<bool> din_valid, din_ready, dout_valid, dout_ready;
+    sc_signal<bool> din_last, dout_last;
+    sc_signal<sc_lv<CFG_WIDTH>> config_data;
+    sc_signal<bool> config_valid, config_ready;
+    sc_signal<bool> harq_valid, harq_hit, harq_ready;
+
+    // Checks the DUT output when testbenchOptions::useScoreboard is set
+    scoreboard board;
+
+    const int inWidth, outWidth;             // din and dout bus widths in bits
+
+    testbench(int inBits, int outBits) : board(inBits, outBits), inWidth(inBits), outWidth(outBits) {}
+    virtual ~testbench() {}
+
+    // Output file of the sink (empty = none) and the expected output checker (nullptr = none)
+    virtual void setOutput(const std::string& path, regressionChecker* checker) = 0;
+
+    // Called once the sink has received every transport block, instead of stopping the simulation
+    virtual void setOnDone(std::function<void()> f) = 0;
+
+    // Add the configuration, din and dout signals to a tracer
+    virtual void trace(waveTracer& tracer) = 0;
+
+    // Print the DUT throughput, and the coverage of random stimulus
+    virtual void report() const = 0;
+
+    // Add the counters of every module, in the order of the data path
+    virtual void writeStats(rmStatsReport& report) const = 0;
+
+    // DUT din and dout handshake counters
+    virtual const rmStreamStats& inputStats() const = 0;
+    virtual const rmStreamStats& outputStats() const = 0;
+};
+
+// Testbench with a width-bit din and beats beats of width bits per cycle on
+// dout, nullptr when the combination is not one of RM_BUS_CONFIGS. Module
+// names end in suffix. The cases must outlive it.
+std::unique_ptr<testbench> makeTestbench(int width, int beats, const std::string& suffix, sc_clock& clk,
+                                         sc_signal<bool>& rst, const std::vector<regressionCase>& cases,
+                                         const testbenchOptions& options);
+
+#endif // TESTBENCH_H
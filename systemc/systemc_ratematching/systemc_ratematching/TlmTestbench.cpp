@@ -0,0 +1,133 @@
+/*
+ * ==============================================
+ * File:        TlmTestbench.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Initiator for the transaction-level rate
+ *              matching model. Packs the code blocks of each
+ *              transport block into one payload and writes
+ *              the rate-matched output as 128-bit lines or
+ *              a vector file.
+ * ==============================================
+ */
+
+#include "TlmTestbench.h"
+#include "RatematchingTlm.h"
+#include <algorithm>
+#include <iostream>
+
+bool tlmTestbench::loadTransportBlock(const regressionCase& tc, size_t b, std::vector<uint64_t>& payload) {
+    ratematchingConfig config = toRatematchingConfig(tc.configs[b]);
+    int C = config.codeBlocks();
+    size_t words = (size_t)C * ratematchingTlm::blockWords(config);
+
+    if (isVectorFile(tc.inPath)) {
+        // One record per transport block, its beats are already beat-aligned blocks
+        rmVectorRecord rec;
+        if ((b == 0 && !vectors.open(tc.inPath)) || !vectors.next(rec)) {
+            return false;
+        }
+        payload.assign(words, 0);
+        int beats = (int)std::min<size_t>(rec.beats, words / 2);
+        return vectors.read(payload.data(), beats) == beats;
+    }
+
+    if (b == 0) {
+        dataWords.clear();
+        nextWord = 0;
+        if (!rmReadTextLines(tc.inPath, dataWords)) {
+            return false;
+        }
+    }
+    if (nextWord + words > dataWords.size()) {
+        std::cerr << "Error: Input data ends inside a transport block" << std::endl;
+        return false;
+    }
+
+    // Code blocks back to back, one input line is one beat (two words)
+    payload.assign(dataWords.begin() + nextWord, dataWords.begin() + nextWord + words);
+    nextWord += words;
+    return true;
+}
+
+void tlmTestbench::run() {
+
+    /****** Open file ******/
+    rmBeatWriter output;
+    if (!outputFile.empty() && !output.open(outputFile)) {
+        std::cerr << "Error: Failed to open output file: " << outputFile << std::endl;
+    }
+
+    std::vector<uint64_t> payload, result;
+    tlm::tlm_generic_payload trans;
+    ratematchingExtension ext;
+    trans.set_extension(&ext);
+
+    // A failed transaction ends the run, the checker reports the cases not finished
+    bool ok = true;
+    for (size_t c = 0; ok && c < cases.size(); ++c) {
+        const regressionCase& tc = cases[c];
+        for (size_t b = 0; ok && b < tc.configs.size(); ++b) {
+            if (!loadTransportBlock(tc, b, payload)) {
+                std::cerr << "Error: Cannot read transport block " << b << " of " << tc.name << std::endl;
+                ok = false;
+                break;
+            }
+            ratematchingConfig config = toRatematchingConfig(tc.configs[b]);
+            result.assign(ratematchingTlm::outputWords(config), 0);
+
+            ext.config = config;
+            ext.out = result.data();
+            ext.outWords = (int)result.size();
+            trans.set_command(tlm::TLM_WRITE_COMMAND);
+            trans.set_address(0);
+            trans.set_data_ptr(reinterpret_cast<unsigned char*>(payload.data()));
+            trans.set_data_length((unsigned)(payload.size() * sizeof(uint64_t)));
+            trans.set_streaming_width((unsigned)(payload.size() * sizeof(uint64_t)));
+            trans.set_byte_enable_ptr(nullptr);
+            trans.set_dmi_allowed(false);
+            trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+            // The scoreboard sees the transaction as the beats of the cycle-accurate model
+            if (board != nullptr) {
+                board->config(config);
+                for (size_t w = 0; w < payload.size(); w += 2) {
+                    board->inputBeat(&payload[w]);
+                }
+            }
+
+            sc_time delay = SC_ZERO_TIME;
+            socket->b_transport(trans, delay);
+            if (trans.is_response_error()) {
+                std::cerr << "Error: Rate matching transaction failed: " << trans.get_response_string() << std::endl;
+                ok = false;
+                break;
+            }
+            wait(delay);
+
+            for (size_t w = 0; w < result.size(); w += 2) {
+                if (output.isOpen()) {
+                    output.write(result[w], result[w + 1]);
+                }
+                if (checker != nullptr) {
+                    checker->beat(result[w], result[w + 1]);
+                }
+                if (board != nullptr) {
+                    board->outputBeat(&result[w], w + 2 == result.size());
+                }
+            }
+            output.endTransportBlock();
+            if (checker != nullptr) {
+                checker->endTransportBlock();
+            }
+        }
+        vectors.close();
+    }
+
+    trans.clear_extension(&ext);
+    output.close();
+    sc_stop();
+}
@@ -0,0 +1,47 @@
+// TlmTestbench.h
+
+#ifndef TLMTESTBENCH_H
+#define TLMTESTBENCH_H
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <string>
+#include <vector>
+#include "source.h"
+
+// Source and sink of the transaction-level model: sends one transaction per
+// transport block of the test cases, then writes and checks the output like
+// sink does
+SC_MODULE(tlmTestbench) {
+public:
+    tlm_utils::simple_initiator_socket<tlmTestbench> socket;
+
+    // The cases, the checker and the scoreboard must outlive the module. outputFile holds the
+    // output lines or vector file, nothing is written when it is empty.
+    SC_HAS_PROCESS(tlmTestbench);
+    tlmTestbench(sc_module_name name, const std::vector<regressionCase>& cases, const std::string& outputFile,
+                 regressionChecker* checker = nullptr, scoreboard* board = nullptr)
+        : sc_module(name), socket("socket"), cases(cases), outputFile(outputFile), checker(checker), board(board) {
+        SC_THREAD(run);
+    }
+
+private:
+    const std::vector<regressionCase>& cases;
+    const std::string outputFile;
+    regressionChecker* checker;
+    scoreboard* board;
+
+    // Input of the current case
+    std::vector<uint64_t> dataWords;           // Input lines, two words each
+    rmVectorReader vectors;                    // Vector file, one record per transaction
+    size_t nextWord = 0;                       // Position in dataWords
+
+    // Code blocks of transport block b of a case as a beat-aligned payload
+    bool loadTransportBlock(const regressionCase& tc, size_t b, std::vector<uint64_t>& payload);
+
+    // Sends the transport blocks in order, waiting out each annotated delay
+    void run();
+};
+
+#endif // TLMTESTBENCH_H
@@ -0,0 +1,225 @@
+/*
+ * ==============================================
+ * File:        Tracer.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Windowed VCD tracing. Selected signals are
+ *              sampled once per clock cycle and only the
+ *              changes inside the time, transport block or
+ *              trigger window are written, with a pre-trigger
+ *              ring buffer.
+ * ==============================================
+ */
+
+#include "Tracer.h"
+#include <cctype>
+#include <sstream>
+
+// Time in VCD units (ps)
+static long long vcdTime(const sc_time& t) {
+    return (long long)(t / sc_time(1, SC_PS) + 0.5);
+}
+
+// Short printable identifier code of signal i
+static std::string vcdId(size_t i) {
+    std::string id;
+    do {
+        id += (char)('!' + i % 94);
+        i /= 94;
+    } while (i != 0);
+    return id;
+}
+
+waveTracer::waveTracer(sc_module_name name, const std::string& path, const std::string& selectionList)
+    : sc_module(name), path(path) {
+    std::stringstream list(selectionList);
+    std::string item;
+    while (std::getline(list, item, ',')) {
+        if (!item.empty()) {
+            selection.push_back(item);
+        }
+    }
+    traceClock = selected("clk", 1);
+
+    SC_METHOD(rising);
+    sensitive << clk.pos();
+    dont_initialize();
+
+    SC_METHOD(falling);
+    sensitive << clk.neg();
+    dont_initialize();
+}
+
+waveTracer::~waveTracer() {
+    if (file.is_open()) {
+        file << "#" << vcdTime(sc_time_stamp()) << "\n";
+    }
+}
+
+bool waveTracer::selected(const std::string& name, int width) const {
+    for (const std::string& s : selection) {
+        if (s == "all" || s == name || (s == "ctrl" && width == 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string waveTracer::unmatched() const {
+    for (const std::string& s : selection) {
+        bool known = (s == "all" || s == "ctrl" || s == "clk");
+        for (size_t i = 0; i < signals.size() && !known; ++i) {
+            known = (signals[i].name == s);
+        }
+        if (!known) {
+            return s;
+        }
+    }
+    return std::string();
+}
+
+void waveTracer::add(const sc_signal<bool>& s, const std::string& name) {
+    if (selected(name, 1)) {
+        signals.push_back({ name, 1, [&s] { return std::string(s.read() ? "1" : "0"); } });
+    }
+}
+
+void waveTracer::setTimeWindow(const sc_time& from, const sc_time& to) {
+    timeFrom = from;
+    timeTo = to;
+}
+
+void waveTracer::setTransportBlockWindow(const sc_signal<bool>& valid, const sc_signal<bool>& ready,
+                                         const sc_signal<bool>& last, long long from, long long to) {
+    tbValid = &valid;
+    tbReady = &ready;
+    tbLast = &last;
+    tbFrom = from;
+    tbTo = to;
+}
+
+void waveTracer::setTrigger(long long post) {
+    triggered = false;
+    postCycles = post;
+}
+
+void waveTracer::trigger() {
+    if (!triggered) {
+        triggered = true;
+        cyclesLeft = postCycles;
+    }
+}
+
+void waveTracer::header() {
+    file.open(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot write trace file: " << path << std::endl;
+        return;
+    }
+    file << "$version " << sc_version() << " $end\n";
+    file << "$timescale 1 ps $end\n";
+    file << "$scope module " << name() << " $end\n";
+    if (traceClock) {
+        file << "$var wire 1 " << vcdId(0) << " clk $end\n";
+    }
+    for (size_t i = 0; i < signals.size(); ++i) {
+        file << "$var wire " << signals[i].width << " " << vcdId(i + 1) << " " << signals[i].name << " $end\n";
+    }
+    file << "$upscope $end\n$enddefinitions $end\n";
+}
+
+void waveTracer::write(const sample& s) {
+    if (!file.is_open()) {
+        return;
+    }
+    file << "#" << s.edge << "\n";
+    if (traceClock) {
+        file << "1" << vcdId(0) << "\n";
+    }
+    written.resize(signals.size());
+    for (size_t i = 0; i < signals.size(); ++i) {
+        const std::string& v = s.values[i];
+        if (v == written[i]) {
+            continue;
+        }
+        written[i] = v;
+        if (signals[i].width == 1) {
+            file << (char)std::tolower(v[0]) << vcdId(i + 1) << "\n";
+            continue;
+        }
+
+        // Vectors without their leading zeros, x and z in lower case
+        size_t first = v.find_first_not_of('0');
+        std::string bits = (first == std::string::npos) ? "0" : v.substr(first);
+        for (char& c : bits) {
+            c = (char)std::tolower(c);
+        }
+        file << "b" << bits << " " << vcdId(i + 1) << "\n";
+    }
+    if (traceClock) {
+        file << "#" << s.fall << "\n0" << vcdId(0) << "\n";
+    }
+}
+
+void waveTracer::rising() {
+    risingEdge = vcdTime(sc_time_stamp());
+
+    // The handshake is taken on this edge
+    if (tbValid != nullptr && tbValid->read() && tbReady->read() && tbLast->read()) {
+        ++tbCount;
+    }
+}
+
+void waveTracer::falling() {
+    if (signals.empty() && !traceClock) {
+        return;
+    }
+
+    sc_time now = sc_time_stamp();
+    bool inWindow = now >= timeFrom && (timeTo == SC_ZERO_TIME || now < timeTo)
+                    && tbCount >= tbFrom && (tbTo < 0 || tbCount < tbTo)
+                    && triggered && cyclesLeft != 0;
+    if (!inWindow && preCycles == 0) {
+        if (open) {
+            written.clear();  // Values are written in full when the window opens again
+            open = false;
+        }
+        return;
+    }
+
+    sample s;
+    s.edge = risingEdge;
+    s.fall = vcdTime(now);
+    s.values.reserve(signals.size());
+    for (const signal& sig : signals) {
+        s.values.push_back(sig.read());
+    }
+
+    if (!inWindow) {
+        if (open) {
+            written.clear();
+            open = false;
+        }
+        ring.push_back(std::move(s));
+        if ((int)ring.size() > preCycles) {
+            ring.pop_front();
+        }
+        return;
+    }
+
+    if (!file.is_open()) {
+        header();
+    }
+    for (const sample& r : ring) {
+        write(r);
+    }
+    ring.clear();
+    write(s);
+    open = true;
+    if (cyclesLeft > 0) {
+        --cyclesLeft;
+    }
+}
@@ -0,0 +1,104 @@
+// Tracer.h
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <systemc.h>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Cycle-based VCD writer. Unlike sc_trace it records each selected signal
+// once per clock cycle, after the processes of the rising edge have run, and
+// it only writes while a window is open: a time window, a window of
+// transport blocks counted on an output handshake, or a window around a
+// trigger such as the first scoreboard mismatch. The last preCycles cycles
+// before a window opens are kept in a ring buffer and written with it.
+SC_MODULE(waveTracer) {
+public:
+    sc_in<bool> clk;
+
+    // selection is "all", "ctrl" (1-bit signals only) or a comma-separated
+    // list of signal names
+    SC_HAS_PROCESS(waveTracer);
+    waveTracer(sc_module_name name, const std::string& path, const std::string& selection = "all");
+    ~waveTracer();
+
+    // Signals to trace, added before the simulation starts; the ones not
+    // selected are ignored. The clock is traced when "clk" is selected.
+    void add(const sc_signal<bool>& s, const std::string& name);
+    template <int W>
+    void add(const sc_signal<sc_lv<W>>& s, const std::string& name) {
+        if (selected(name, W)) {
+            signals.push_back({ name, W, [&s] { return s.read().to_string(); } });
+        }
+    }
+
+    // Write only from `from` to `to`, to = SC_ZERO_TIME for the end of the simulation
+    void setTimeWindow(const sc_time& from, const sc_time& to);
+
+    // Write only while the number of transport blocks completed on the
+    // handshake (valid, ready, last) is in [from, to), to = -1 for no end
+    void setTransportBlockWindow(const sc_signal<bool>& valid, const sc_signal<bool>& ready,
+                                 const sc_signal<bool>& last, long long from, long long to);
+
+    // Write nothing until trigger(), then postCycles more cycles
+    void setTrigger(long long postCycles);
+    void trigger();
+
+    // Cycles kept in front of a window (default 0)
+    void setPreCycles(int cycles) { preCycles = cycles < 0 ? 0 : cycles; }
+
+    // Number of signals that will be written
+    int size() const { return (int)signals.size(); }
+
+    // First name of the selection that is none of the signals added, empty if all are known
+    std::string unmatched() const;
+
+private:
+    struct signal {
+        std::string name;
+        int width;
+        std::function<std::string()> read;   // Value as 0/1/X/Z, MSB first
+    };
+    struct sample {
+        long long edge;                      // Rising edge, in ps
+        long long fall;                      // Falling edge, in ps
+        std::vector<std::string> values;
+    };
+
+    const std::string path;
+    std::vector<std::string> selection;
+    std::ofstream file;
+    bool traceClock = false;
+    std::vector<signal> signals;
+
+    // Windows
+    sc_time timeFrom, timeTo;
+    const sc_signal<bool>* tbValid = nullptr;
+    const sc_signal<bool>* tbReady = nullptr;
+    const sc_signal<bool>* tbLast = nullptr;
+    long long tbFrom = 0, tbTo = -1, tbCount = 0;
+    bool triggered = true;
+    long long postCycles = -1, cyclesLeft = -1;
+
+    int preCycles = 0;
+    std::deque<sample> ring;                 // Cycles before the window
+    std::vector<std::string> written;        // Values in the file, empty after a gap
+    bool open = false;                       // The window was open last cycle
+    long long risingEdge = 0;                // Time of the last rising edge, in ps
+
+    bool selected(const std::string& name, int width) const;
+    void header();
+    void write(const sample& s);
+
+    // Rising edge: time stamp and transport block count
+    void rising();
+
+    // Falling edge: sample the signals written on the rising edge
+    void falling();
+};
+
+#endif // TRACER_H
@@ -12,40 +12,180 @@
  */
 
 #include "ratematching.h"
-#include "source.h"
-#include "sink.h"
+#include "Testbench.h"
+#include "RatematchingTlm.h"
+#include "TlmTestbench.h"
+#include "Regression.h"
+#include "Scoreboard.h"
+#include "Generator.h"
+#include "Deratematching.h"
+#include "Loopback.h"
+#include "Tracer.h"
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <iomanip>
+#include <memory>
+#include <string>
 
-int sc_main(int argc, char* argv[]) {
+// SystemC verbosity from its name (none, low, medium, high, full, debug) or number, -1 if unknown
+static int verbosityLevel(const char* text) {
+    static const struct { const char* name; int level; } levels[] = {
+        { "none", SC_NONE }, { "low", SC_LOW }, { "medium", SC_MEDIUM },
+        { "high", SC_HIGH }, { "full", SC_FULL }, { "debug", SC_DEBUG }
+    };
+    for (const auto& l : levels) {
+        if (std::strcmp(text, l.name) == 0) {
+            return l.level;
+        }
+    }
+    char* end;
+    long level = std::strtol(text, &end, 10);
+    return (*text != 0 && *end == 0 && level >= 0) ? (int)level : -1;
+}
 
-    // Signal declarations
-    sc_signal<bool> din_valid, din_ready, dout_valid, dout_ready;
-    sc_signal<bool> din_last, dout_last;
-    sc_signal<sc_lv<128>> din_data, dout_data;
+// "FROM:TO" or "FROM:", to = -1 when there is no end
+static bool parseRange(const char* text, double& from, double& to) {
+    char* end;
+    from = std::strtod(text, &end);
+    if (end == text || *end != ':') {
+        return false;
+    }
+    text = end + 1;
+    to = (*text == 0) ? -1 : std::strtod(text, &end);
+    return *text == 0 || *end == 0;
+}
 
-    sc_signal<sc_lv<CFG_WIDTH>> config_data;
-    sc_signal<bool> config_valid, config_ready;
+// Run until the testbench stops the simulation, or for at most timeLimit ns
+static void run(double timeLimit) {
+    if (timeLimit > 0) {
+        sc_start(timeLimit, SC_NS);
+    }
+    else {
+        sc_start();
+    }
+}
 
-    // Clock and Reset signals
+// Transaction-level run: one blocking transport call per transport block
+static void runTlm(const std::vector<regressionCase>& cases, const std::string& outputFile,
+                   regressionChecker& checker, scoreboard* board, double timeLimit,
+                   const std::string& statsFile) {
+    tlmTestbench testbench("testbench", cases, outputFile, &checker, board);
+    ratematchingTlm rate_matching("ratematching");
+    testbench.socket.bind(rate_matching.socket);
+
+    std::cout << "\nStarting transaction-level simulation...\n" << std::endl;
+    run(timeLimit); // The testbench stops it after the last transport block
+    std::cout << "Simulated time: " << sc_time_stamp() << std::endl;
+    rate_matching.reportThroughput();
+    if (!statsFile.empty()) {
+        rmStatsReport report;
+        rate_matching.writeStats(report);
+        report.write(statsFile);
+    }
+}
+
+// Run every bus configuration side by side on the same stimulus and print the
+// cycles and bits per cycle of each. Non-zero exit code unless every
+// configuration received all transport blocks and passed its scoreboard.
+static int compareWidths(const std::vector<regressionCase>& cases, const testbenchOptions& options,
+                         double timeLimit, const std::string& statsFile) {
     sc_clock clk("clk", 10, SC_NS);  // 10ns clock period
     sc_signal<bool> rst;
 
-    // Instantiate modules
-    source source("source");
-    sink sink("sink");
-    ratematching rate_matching("ratematching");
-
-    // Connect signals for Source module
-    source.clk(clk);
-    source.rst(rst);
-    source.config_data(config_data);
-    source.config_valid(config_valid);
-    source.config_ready(config_ready);
-    source.dout_data(din_data);
-    source.dout_valid(din_valid);
-    source.dout_ready(din_ready);
-    source.dout_last(din_last);
-
-    // Connect signals for RateMatching module
+    // The last sink to finish stops the simulation
+    std::vector<std::unique_ptr<testbench>> benches;
+    int running = 0;
+#define RM_ADD_TESTBENCH(W, B) \
+    benches.push_back(makeTestbench(W, B, "_" #W "x" #B, clk, rst, cases, options));
+    RM_BUS_CONFIGS(RM_ADD_TESTBENCH)
+#undef RM_ADD_TESTBENCH
+    for (std::unique_ptr<testbench>& bench : benches) {
+        bench->setOnDone([&running] {
+            if (--running == 0) {
+                sc_stop();
+            }
+        });
+        ++running;
+    }
+
+    std::cout << "\nStarting simulation of " << benches.size() << " bus configurations...\n" << std::endl;
+    run(timeLimit);
+
+    // Cycles from the start to the last output beat; the bits per cycle include the padding of each bus
+    long long baseCycles = benches[0]->outputStats().lastBeat + 1;
+    std::cout << "Bus comparison, same stimulus:" << std::endl;
+    std::cout << "   din  dout  beats    cycles  speedup  din bits/cycle  dout bits/cycle  scoreboard" << std::endl;
+    int result = (running == 0) ? 0 : 1;
+    std::streamsize precision = std::cout.precision();
+    for (const std::unique_ptr<testbench>& bench : benches) {
+        const rmStreamStats& in = bench->inputStats();
+        const rmStreamStats& out = bench->outputStats();
+        long long cycles = out.lastBeat + 1;
+        const char* check = !options.useScoreboard ? "-" : bench->board.passed() ? "PASS" : "FAIL";
+        std::cout << std::fixed << std::setprecision(2) << std::setw(6) << bench->inWidth << std::setw(6)
+                  << bench->outWidth << std::setw(7) << bench->outWidth / bench->inWidth << std::setw(10)
+                  << cycles << std::setw(9) << (cycles > 0 ? (double)baseCycles / cycles : 0.0) << std::setw(16)
+                  << in.beatsPerCycle() * bench->inWidth << std::setw(17) << out.beatsPerCycle() * bench->outWidth
+                  << std::setw(12) << check << std::endl;
+        if (options.useScoreboard && !bench->board.passed()) {
+            result = 1;
+        }
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout.precision(precision);
+    if (options.random) {
+        benches[0]->report();
+    }
+
+    if (!statsFile.empty()) {
+        rmStatsReport report;
+        for (const std::unique_ptr<testbench>& bench : benches) {
+            bench->writeStats(report);
+        }
+        report.write(statsFile);
+    }
+    return result;
+}
+
+// Loopback run: the random transport blocks go through ratematching, a noise-free
+// channel and deratematching, and the soft values that come back are checked
+// against the input bits. Non-zero exit code unless every one of them passed.
+static int runLoopback(const testbenchOptions& options, double timeLimit,
+                       std::chrono::steady_clock::time_point start) {
+    sc_clock clk("clk", 10, SC_NS);  // 10ns clock period
+    sc_signal<bool> rst;
+
+    // Generator to ratematching, ratematching to the channel
+    sc_signal<sc_lv<CFG_WIDTH>> config_data;
+    sc_signal<bool> config_valid, config_ready;
+    sc_signal<sc_lv<sizePort>> din_data, rm_data;
+    sc_signal<bool> din_valid, din_ready, din_last, rm_valid, rm_ready, rm_last;
+    sc_signal<bool> harq_valid, harq_hit, harq_ready;
+
+    // Channel to deratematching, deratematching to the checker
+    sc_signal<sc_lv<CFG_WIDTH>> drm_config_data;
+    sc_signal<bool> drm_config_valid, drm_config_ready;
+    sc_signal<sc_lv<128>> llr_data, soft_data;
+    sc_signal<bool> llr_valid, llr_ready, llr_last, soft_valid, soft_ready, soft_last;
+
+    generator<sizePort> stimulus("generator", options.constraints);
+    stimulus.clk(clk);
+    stimulus.rst(rst);
+    stimulus.config_data(config_data);
+    stimulus.config_valid(config_valid);
+    stimulus.config_ready(config_ready);
+    stimulus.dout_data(din_data);
+    stimulus.dout_valid(din_valid);
+    stimulus.dout_last(din_last);
+    stimulus.dout_ready(din_ready);
+    stimulus.harq_valid(harq_valid);
+    stimulus.harq_hit(harq_hit);
+    stimulus.harq_ready(harq_ready);
+
+    ratematching<sizePort, 1> rate_matching("ratematching", options.outFifoDepth, options.cfgFifoDepth);
+    rate_matching.setCutThrough(options.cutThrough);
+    rate_matching.setHarqCapacity(options.harqCapacity);
     rate_matching.clk(clk);
     rate_matching.rst(rst);
     rate_matching.config_data(config_data);
@@ -53,42 +193,450 @@ int sc_main(int argc, char* argv[]) {
     rate_matching.config_ready(config_ready);
     rate_matching.din_data(din_data);
     rate_matching.din_valid(din_valid);
+    rate_matching.din_last(din_last);
     rate_matching.din_ready(din_ready);
-    rate_matching.din_last(din_last);  // Fixed din_last signal mapping
-    rate_matching.dout_data(dout_data);
-    rate_matching.dout_valid(dout_valid);
-    rate_matching.dout_ready(dout_ready);
-    rate_matching.dout_last(dout_last);
-
-    // Connect signals for Sink module
-    sink.clk(clk);
-    sink.rst(rst);
-    sink.din_ready(dout_ready);
-    sink.din_valid(dout_valid);
-    sink.din_data(dout_data);
-    sink.din_last(dout_last);
-
-    /* Trace for debugging */
-    sc_trace_file* wave_form = sc_create_vcd_trace_file("tb_ratematching");
-    sc_trace(wave_form, clk, "clk");
-    sc_trace(wave_form, rst, "rst_n");
-    sc_trace(wave_form, config_data, "cfg_data");
-    sc_trace(wave_form, config_valid, "cfg_vld");
-    sc_trace(wave_form, config_ready, "cfg_rdy");
-    sc_trace(wave_form, din_data, "input_data");
-    sc_trace(wave_form, din_valid, "input_vld");
-    sc_trace(wave_form, din_ready, "input_rdy");
-    sc_trace(wave_form, din_last, "input_last");
-    sc_trace(wave_form, dout_data, "output_data");
-    sc_trace(wave_form, dout_valid, "output_vld");
-    sc_trace(wave_form, dout_ready, "output_rdy");
-    sc_trace(wave_form, dout_last, "output_last");
+    rate_matching.dout_data(rm_data);
+    rate_matching.dout_valid(rm_valid);
+    rate_matching.dout_last(rm_last);
+    rate_matching.dout_ready(rm_ready);
+    rate_matching.harq_valid(harq_valid);
+    rate_matching.harq_hit(harq_hit);
+    rate_matching.harq_ready(harq_ready);
+
+    loopbackChannel channel("channel");
+    channel.clk(clk);
+    channel.rst(rst);
+    channel.rm_config_data(config_data);
+    channel.rm_config_valid(config_valid);
+    channel.rm_config_ready(config_ready);
+    channel.din_data(rm_data);
+    channel.din_valid(rm_valid);
+    channel.din_last(rm_last);
+    channel.din_ready(rm_ready);
+    channel.dout_data(llr_data);
+    channel.dout_valid(llr_valid);
+    channel.dout_last(llr_last);
+    channel.dout_ready(llr_ready);
+    channel.config_data(drm_config_data);
+    channel.config_valid(drm_config_valid);
+    channel.config_ready(drm_config_ready);
+
+    // A soft buffer for every HARQ process and code block the generator may draw
+    deratematching derate_matching("deratematching", 16, std::max(options.constraints.maxCodeBlocks, 1));
+    derate_matching.clk(clk);
+    derate_matching.rst(rst);
+    derate_matching.din_data(llr_data);
+    derate_matching.din_valid(llr_valid);
+    derate_matching.din_last(llr_last);
+    derate_matching.din_ready(llr_ready);
+    derate_matching.dout_data(soft_data);
+    derate_matching.dout_valid(soft_valid);
+    derate_matching.dout_last(soft_last);
+    derate_matching.dout_ready(soft_ready);
+    derate_matching.config_data(drm_config_data);
+    derate_matching.config_valid(drm_config_valid);
+    derate_matching.config_ready(drm_config_ready);
+
+    loopbackChecker checker("checker", options.constraints.transportBlocks);
+    checker.clk(clk);
+    checker.rst(rst);
+    checker.config_data(config_data);
+    checker.config_valid(config_valid);
+    checker.config_ready(config_ready);
+    checker.din_data(din_data);
+    checker.din_valid(din_valid);
+    checker.din_ready(din_ready);
+    checker.harq_valid(harq_valid);
+    checker.harq_hit(harq_hit);
+    checker.harq_ready(harq_ready);
+    checker.soft_data(soft_data);
+    checker.soft_valid(soft_valid);
+    checker.soft_last(soft_last);
+    checker.soft_ready(soft_ready);
+
+    std::cout << "\nStarting loopback simulation...\n" << std::endl;
+    run(timeLimit); // The checker stops it after the last transport block
+    std::cout << "Simulated time: " << sc_time_stamp() << std::endl;
+    rate_matching.reportThroughput();
+    stimulus.reportCoverage();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Wall time: " << seconds << " s" << std::endl;
+    checker.report();
+    return checker.passed() ? 0 : 1;
+}
+
+// Print the regression result, non-zero exit code unless every case passed.
+// There is no checker for random stimulus, only the scoreboard.
+static int finish(const regressionChecker* checker, const scoreboard* board,
+                  std::chrono::steady_clock::time_point start) {
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (checker != nullptr) {
+        checker->report(seconds);
+    }
+    else {
+        std::cout << "Wall time: " << seconds << " s" << std::endl;
+    }
+    if (board != nullptr) {
+        board->report();
+        if (!board->passed()) {
+            return 1;
+        }
+    }
+    return (checker == nullptr || (checker->failures() == 0 && checker->done())) ? 0 : 1;
+}
+
+int sc_main(int argc, char* argv[]) {
+
+    // Options: --out-fifo-depth=N  output FIFO depth in beats
+    //          --sink-ready=R      cycles the sink is ready per period
+    //          --sink-stall=S      cycles the sink stalls per period
+    //          --sink-seed=X       random stalls instead of a fixed period
+    //          --cfg-fifo-depth=N  configurations queued ahead of their data
+    //          --tlm               transaction-level model instead of the cycle-accurate one
+    //          --config=FILE       configuration file of a single test case
+    //          --input=FILE        input lines, or a vector file (.rmv) holding the configurations
+    //          --expected=FILE     expected output lines or vector file, "-" = not checked
+    //          --manifest=FILE     test cases to run one after the other instead
+    //          --output=FILE       output file, a vector file when it ends in .rmv, "-" = none
+    //          --time-limit=NS     stop the simulation after NS ns instead of when all cases are done
+    //          --no-scoreboard     do not check the output against the built-in reference model
+    //          --stop-on-mismatch  stop the simulation at the first beat the scoreboard rejects
+    //          --random=N          N constrained-random transport blocks instead of the test cases
+    //          --seed=S            seed of the random configurations and data
+    //          --max-code-blocks=C up to C code blocks per random transport block (default 1)
+    //          --max-outlen=L      largest random output length per code block
+    //          --max-filler=F      up to F random filler bits per code block (default 0)
+    //          --retransmit-rate=P share P (0..1) of random transport blocks that retransmit the last
+    //                              codeword of a HARQ process with a new rv (default 0)
+    //          --harq-processes=N  HARQ processes of the random transport blocks, 1..16 (default 8)
+    //          --harq-capacity=B   HARQ codeword store of the DUT in bits (default 4194304), 0 = none
+    //          --stats=FILE        performance counters of every module, JSON when FILE ends in .json, else CSV
+    //          --verbosity=LEVEL   module messages up to none, low, medium (default), high, full or debug
+    //          --trace=SIGNALS     none, all, ctrl (1-bit signals) or a comma-separated list of signal names;
+    //                              all for a single test case, none for a manifest or random run by default
+    //          --trace-file=FILE   VCD file, tb_ratematching.vcd by default
+    //          --trace-window=A:B  trace from A ns to B ns only (B may be left out)
+    //          --trace-tb=A:B      trace while transport blocks A to B-1 leave the DUT
+    //          --trace-on-mismatch trace around the first scoreboard mismatch only
+    //          --trace-pre=N       cycles written ahead of the window (default 0, 1000 with --trace-on-mismatch)
+    //          --trace-post=N      cycles written after the mismatch (default 1000)
+    //          --bus-width=W       din width 128 (default), 256 or 512 bits
+    //          --beats-per-cycle=B dout carries B beats of W bits per cycle, 1 (default), 2 or 4;
+    //                              output files then hold whole W x B bit words
+    //          --compare-widths    run every bus width and beats per cycle side by side on the same
+    //                              stimulus and print the throughput of each
+    //          --lanes=N           N rate matching lanes behind a dispatcher and an in-order collector
+    //                              (default 1, a single module); prints the utilisation of each lane
+    //          --cut-through       send output beats as soon as the input bits they depend on are in,
+    //                              instead of after the whole code block
+    //          --loopback          pass the random transport blocks through ratematching and back through
+    //                              deratematching and check the signs of the soft values; up to 4 code
+    //                              blocks and half of them retransmissions unless given otherwise
+    // Paths default to the io directory of the repository, seen from the project directory.
+    // An unknown option, or a --trace name that is no signal, is an error and nothing runs.
+    testbenchOptions options;
+    int busWidth = sizePort, beatsPerCycle = 1;
+    bool compare = false;
+    bool tlm = false;
+    double timeLimit = 0;
+    std::string cfgFile = "../../../io/input/config_inputdata2.txt";
+    std::string inputFile = "../../../io/input/input_data2.txt";
+    std::string expectedFile = "../../../io/output/output_data2_matlab.txt";
+    std::string outputFile = "../../../io/output/output_data2.txt";
+    std::string manifestFile;
+    std::string statsFile;
+    std::string traceSignals, traceFile = "tb_ratematching.vcd";
+    double traceFrom = 0, traceTo = -1, traceTbFrom = 0, traceTbTo = -1;
+    bool traceWindow = false, traceTb = false, traceOnMismatch = false;
+    int tracePre = -1;
+    long long tracePost = 1000;
+    bool outputSet = false;
+    generatorConstraints constraints;
+    bool random = false;
+    bool loopback = false, codeBlocksSet = false, retransmitSet = false;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--out-fifo-depth=", 17) == 0) {
+            options.outFifoDepth = std::atoi(arg + 17);
+        }
+        else if (std::strncmp(arg, "--cfg-fifo-depth=", 17) == 0) {
+            options.cfgFifoDepth = std::atoi(arg + 17);
+        }
+        else if (std::strncmp(arg, "--sink-ready=", 13) == 0) {
+            options.sinkReady = std::atoi(arg + 13);
+        }
+        else if (std::strncmp(arg, "--sink-stall=", 13) == 0) {
+            options.sinkStall = std::atoi(arg + 13);
+        }
+        else if (std::strncmp(arg, "--sink-seed=", 12) == 0) {
+            options.sinkSeed = (unsigned)std::strtoul(arg + 12, nullptr, 10);
+        }
+        else if (std::strcmp(arg, "--tlm") == 0) {
+            tlm = true;
+        }
+        else if (std::strncmp(arg, "--config=", 9) == 0) {
+            cfgFile = arg + 9;
+        }
+        else if (std::strncmp(arg, "--input=", 8) == 0) {
+            inputFile = arg + 8;
+        }
+        else if (std::strncmp(arg, "--expected=", 11) == 0) {
+            expectedFile = arg + 11;
+        }
+        else if (std::strncmp(arg, "--manifest=", 11) == 0) {
+            manifestFile = arg + 11;
+        }
+        else if (std::strncmp(arg, "--output=", 9) == 0) {
+            outputFile = arg + 9;
+            outputSet = true;
+        }
+        else if (std::strncmp(arg, "--time-limit=", 13) == 0) {
+            timeLimit = std::atof(arg + 13);
+        }
+        else if (std::strcmp(arg, "--no-scoreboard") == 0) {
+            options.useScoreboard = false;
+        }
+        else if (std::strcmp(arg, "--stop-on-mismatch") == 0) {
+            options.stopOnMismatch = true;
+        }
+        else if (std::strncmp(arg, "--random=", 9) == 0) {
+            constraints.transportBlocks = std::atoll(arg + 9);
+            random = true;
+        }
+        else if (std::strncmp(arg, "--seed=", 7) == 0) {
+            constraints.seed = (unsigned)std::strtoul(arg + 7, nullptr, 10);
+        }
+        else if (std::strncmp(arg, "--max-code-blocks=", 18) == 0) {
+            constraints.maxCodeBlocks = std::atoi(arg + 18);
+            codeBlocksSet = true;
+        }
+        else if (std::strncmp(arg, "--max-outlen=", 13) == 0) {
+            constraints.maxOutlen = std::atoi(arg + 13);
+        }
+        else if (std::strncmp(arg, "--max-filler=", 13) == 0) {
+            constraints.maxFiller = std::atoi(arg + 13);
+        }
+        else if (std::strncmp(arg, "--retransmit-rate=", 18) == 0) {
+            constraints.retransmitRate = std::atof(arg + 18);
+            retransmitSet = true;
+        }
+        else if (std::strncmp(arg, "--harq-processes=", 17) == 0) {
+            constraints.harqProcesses = std::atoi(arg + 17);
+            if (constraints.harqProcesses < 1 || constraints.harqProcesses > 16) {
+                std::cerr << "Error: Expected --harq-processes=N with 1 <= N <= 16" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strncmp(arg, "--harq-capacity=", 16) == 0) {
+            options.harqCapacity = std::atoll(arg + 16);
+        }
+        else if (std::strncmp(arg, "--stats=", 8) == 0) {
+            statsFile = arg + 8;
+        }
+        else if (std::strncmp(arg, "--trace=", 8) == 0) {
+            traceSignals = arg + 8;
+        }
+        else if (std::strncmp(arg, "--trace-file=", 13) == 0) {
+            traceFile = arg + 13;
+        }
+        else if (std::strncmp(arg, "--trace-window=", 15) == 0) {
+            traceWindow = parseRange(arg + 15, traceFrom, traceTo);
+            if (!traceWindow) {
+                std::cerr << "Error: Expected --trace-window=FROM:TO" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strncmp(arg, "--trace-tb=", 11) == 0) {
+            traceTb = parseRange(arg + 11, traceTbFrom, traceTbTo);
+            if (!traceTb) {
+                std::cerr << "Error: Expected --trace-tb=FROM:TO" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strcmp(arg, "--trace-on-mismatch") == 0) {
+            traceOnMismatch = true;
+        }
+        else if (std::strncmp(arg, "--trace-pre=", 12) == 0) {
+            tracePre = std::atoi(arg + 12);
+        }
+        else if (std::strncmp(arg, "--trace-post=", 13) == 0) {
+            tracePost = std::atoll(arg + 13);
+        }
+        else if (std::strncmp(arg, "--bus-width=", 12) == 0) {
+            busWidth = std::atoi(arg + 12);
+        }
+        else if (std::strncmp(arg, "--beats-per-cycle=", 18) == 0) {
+            beatsPerCycle = std::atoi(arg + 18);
+        }
+        else if (std::strcmp(arg, "--compare-widths") == 0) {
+            compare = true;
+        }
+        else if (std::strcmp(arg, "--cut-through") == 0) {
+            options.cutThrough = true;
+        }
+        else if (std::strcmp(arg, "--loopback") == 0) {
+            loopback = true;
+        }
+        else if (std::strncmp(arg, "--lanes=", 8) == 0) {
+            options.lanes = std::atoi(arg + 8);
+            if (options.lanes < 1) {
+                std::cerr << "Error: Expected --lanes=N with N >= 1" << std::endl;
+                return 1;
+            }
+        }
+        else if (std::strncmp(arg, "--verbosity=", 12) == 0) {
+            int level = verbosityLevel(arg + 12);
+            if (level < 0) {
+                std::cerr << "Error: Unknown verbosity: " << arg + 12 << std::endl;
+                return 1;
+            }
+            sc_report_handler::set_verbosity_level(level);
+        }
+        else {
+            std::cerr << "Error: Unrecognized option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Test cases, a manifest run writes no output file unless asked to
+    std::vector<regressionCase> cases;
+    if (loopback) {
+        if (!random || tlm || compare || options.lanes > 1 || busWidth != sizePort || beatsPerCycle != 1) {
+            std::cerr << "Error: The loopback needs --random=N on a single " << sizePort << "-bit module" << std::endl;
+            return 1;
+        }
+        constraints.maxCodeBlocks = codeBlocksSet ? constraints.maxCodeBlocks : 4;
+        constraints.retransmitRate = retransmitSet ? constraints.retransmitRate : 0.5;
+    }
+    options.random = random;
+    options.constraints = constraints;
+    // The transaction-level model has the default bus only
+    if (tlm && (compare || busWidth != sizePort || beatsPerCycle != 1)) {
+        std::cerr << "Error: The transaction-level model has a " << sizePort << "-bit bus only" << std::endl;
+        return 1;
+    }
+    if (tlm && options.lanes > 1) {
+        std::cerr << "Error: The transaction-level model has a single lane only" << std::endl;
+        return 1;
+    }
+
+    if (random) {
+        if (tlm) {
+            std::cerr << "Error: Random stimulus needs the cycle-accurate model" << std::endl;
+            return 1;
+        }
+        if (constraints.transportBlocks < 1) {
+            std::cerr << "Error: No transport blocks to simulate" << std::endl;
+            return 1;
+        }
+        if (!outputSet) {
+            outputFile.clear();
+        }
+    }
+    else if (!manifestFile.empty()) {
+        if (!readManifest(manifestFile, cases)) {
+            return 1;
+        }
+        if (!outputSet) {
+            outputFile.clear();
+        }
+    }
+    else {
+        regressionCase tc;
+        tc.name = inputFile;
+        if (!makeCase(cfgFile, inputFile, (expectedFile == "-") ? "" : expectedFile, tc)) {
+            return 1;
+        }
+        cases.push_back(tc);
+    }
+    if (outputFile == "-") {
+        outputFile.clear();
+    }
+
+    regressionChecker checker(cases, busWidth * beatsPerCycle);
+    if (!random && checker.transportBlocks() == 0) {
+        std::cerr << "Error: No transport blocks to simulate" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (loopback) {
+        return runLoopback(options, timeLimit, start);
+    }
+    if (tlm) {
+        // Golden reference check of every output beat, independent of the expected files
+        scoreboard board;
+        board.setStopOnMismatch(options.stopOnMismatch);
+        scoreboard* boardPtr = options.useScoreboard ? &board : nullptr;
+        runTlm(cases, outputFile, checker, boardPtr, timeLimit, statsFile);
+        return finish(&checker, boardPtr, start);
+    }
+    if (compare) {
+        int result = compareWidths(cases, options, timeLimit, statsFile);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Wall time: " << seconds << " s" << std::endl;
+        return result;
+    }
+
+    // Clock and Reset signals
+    sc_clock clk("clk", 10, SC_NS);  // 10ns clock period
+    sc_signal<bool> rst;
+
+    // Source or random generator, RateMatching and Sink on the selected buses
+    std::unique_ptr<testbench> bench = makeTestbench(busWidth, beatsPerCycle, "", clk, rst, cases, options);
+    if (!bench) {
+        std::cerr << "Error: Unsupported bus: " << busWidth << " bits, " << beatsPerCycle << " beats per cycle"
+                  << std::endl;
+        return 1;
+    }
+    bench->setOutput(outputFile, random ? nullptr : &checker);
+
+    /* Trace for debugging, a single test case traces everything unless asked otherwise */
+    if (traceSignals.empty()) {
+        traceSignals = (random || !manifestFile.empty()) ? "none" : "all";
+    }
+    std::unique_ptr<waveTracer> tracer;
+    if (traceSignals != "none") {
+        tracer.reset(new waveTracer("tb_ratematching", traceFile, traceSignals));
+        tracer->clk(clk);
+        tracer->add(rst, "rst_n");
+        bench->trace(*tracer);
+        std::string unknown = tracer->unmatched();
+        if (!unknown.empty()) {
+            std::cerr << "Error: No signal to trace is called " << unknown << std::endl;
+            return 1;
+        }
+
+        if (traceWindow) {
+            tracer->setTimeWindow(sc_time(traceFrom, SC_NS), (traceTo < 0) ? SC_ZERO_TIME : sc_time(traceTo, SC_NS));
+        }
+        if (traceTb) {
+            tracer->setTransportBlockWindow(bench->dout_valid, bench->dout_ready, bench->dout_last,
+                                            (long long)traceTbFrom, (long long)traceTbTo);
+        }
+        if (traceOnMismatch) {
+            waveTracer* t = tracer.get();
+            tracer->setTrigger(tracePost);
+            bench->board.setOnMismatch([t] { t->trigger(); });
+            if (tracePre < 0) {
+                tracePre = 1000;
+            }
+        }
+        tracer->setPreCycles(tracePre < 0 ? 0 : tracePre);
+    }
 
     // Start Simulation
     std::cout << "\nStarting simulation...\n" << std::endl;
-    sc_start(1000, SC_NS); // Run simulation
+    run(timeLimit); // The sink stops the simulation after the last transport block beat
+    bench->report();
+
+    // Performance counters, in the order of the data path
+    if (!statsFile.empty()) {
+        rmStatsReport report;
+        bench->writeStats(report);
+        report.write(statsFile);
+    }
 
     // End simulation
-    sc_close_vcd_trace_file(wave_form);
-    return 0;
+    return finish(random ? nullptr : &checker, options.useScoreboard ? &bench->board : nullptr, start);
 }
\ No newline at end of file
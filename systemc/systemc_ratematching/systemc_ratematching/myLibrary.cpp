@@ -1,23 +1,5 @@
 #include "myLibrary.h"
-
-// Helper function for floor
-int myFloor(double x) {
-    int intPart = static_cast<int>(x);
-    if (x < 0 && x != intPart) {
-        return intPart - 1;
-    }
-    return intPart;
-}
-
-// Helper function for ceil
-int myCeil(double x) {
-    int intPart = static_cast<int>(x);
-    if (x > 0 && x != intPart) {
-        return intPart + 1;
-    }
-    return intPart;
-}
-
+#include "rmVector.h"
 
 // Check error function
 int checkError(const sc_lv<128>& sinkData, const sc_lv<128>& outputData) {
@@ -32,26 +14,28 @@ int checkError(const sc_lv<128>& sinkData, const sc_lv<128>& outputData) {
     return errorCount;
 }
 
-void readDataFromFile(const std::string& filePath, std::vector<sc_lv<128>>& dataBuffer) {
-    // Open the file
-    std::ifstream inputFile(filePath);
-
-    // Check if the file opened successfully
-    if (!inputFile.is_open()) {
-        std::cerr << "Error: Could not open file " << filePath << std::endl;
-        return;
+// Check error on packed words, counting the differing bits a word at a time
+int checkError(const uint64_t* sinkData, const uint64_t* outputData, int words) {
+    int errorCount = 0;
+    for (int i = 0; i < words; ++i) {
+        uint64_t x = sinkData[i] ^ outputData[i];
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        errorCount += (int)((x * 0x0101010101010101ULL) >> 56);
     }
 
-    // Read lines from the file
-    std::string line;
-    while (std::getline(inputFile, line)) {
-        // Check if the line has exactly 128 characters
-        if (line.length() == 128) {
-            // Store the line as sc_lv<128>
-            dataBuffer.push_back(sc_lv<128>(line.c_str()));
-        }
-    }
+    return errorCount;
+}
 
-    // Close the file
-    inputFile.close();
+void readDataFromFile(const std::string& filePath, std::vector<sc_lv<128>>& dataBuffer) {
+    // Lines are parsed to packed words, then stored as sc_lv<128>
+    std::vector<uint64_t> words;
+    rmReadTextLines(filePath, words);
+    for (size_t i = 0; i + 1 < words.size(); i += 2) {
+        sc_lv<128> data;
+        data.range(127, 64) = words[i];
+        data.range(63, 0) = words[i + 1];
+        dataBuffer.push_back(data);
+    }
 }
\ No newline at end of file
@@ -4,11 +4,10 @@
 #define MYLIBRARY_H
 
 #include <systemc.h>
+#include "myMath.h"
 
-// Function declarations for floor and ceil operations
-int myFloor(double x);
-int myCeil(double x);
 int checkError(const sc_lv<128>& sinkData, const sc_lv<128>& outputData);
+int checkError(const uint64_t* sinkData, const uint64_t* outputData, int words);
 void readDataFromFile(const std::string& filePath, std::vector<sc_lv<128>>& dataBuffer);
 
 #endif // MYLIBRARY
\ No newline at end of file
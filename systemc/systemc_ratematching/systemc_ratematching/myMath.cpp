@@ -0,0 +1,19 @@
+#include "myMath.h"
+
+// Helper function for floor
+int myFloor(double x) {
+    int intPart = static_cast<int>(x);
+    if (x < 0 && x != intPart) {
+        return intPart - 1;
+    }
+    return intPart;
+}
+
+// Helper function for ceil
+int myCeil(double x) {
+    int intPart = static_cast<int>(x);
+    if (x > 0 && x != intPart) {
+        return intPart + 1;
+    }
+    return intPart;
+}
@@ -0,0 +1,10 @@
+// myMath.h
+
+#ifndef MYMATH_H
+#define MYMATH_H
+
+// Function declarations for floor and ceil operations, without SystemC
+int myFloor(double x);
+int myCeil(double x);
+
+#endif // MYMATH_H
@@ -0,0 +1,51 @@
+/*
+ * ==============================================
+ * File:        rmBatch.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Transport block rate matching on packed
+ *              buffers, for use outside the SystemC model
+ *              (link level simulation, offline regression,
+ *              benchmarks).
+ * ==============================================
+ */
+
+#include "rmBatch.h"
+#include <algorithm>
+
+int rmBatch::rateMatch(const rmTbConfig& cfg, const uint64_t* cb, uint64_t* out, int cbStride) {
+    int C = std::max(cfg.C, 1);
+    int cbWords = (cbStride > 0) ? cbStride : rmNumWords(cfg.N);
+    int outBits = 0;
+
+    for (int r = 0; r < C; ++r) {
+        int E = rmBlockE(cfg.G, C, r, cfg.nlayers, cfg.Qm);
+        const rmPlan& plan = cache.get(cfg.N, cfg.rv, cfg.Nref, E, cfg.Qm, cfg.F);
+
+        // Grow only
+        int eWords = rmNumWords(E);
+        if ((int)selected.size() < eWords) {
+            selected.resize(eWords);
+            interleaved.resize(eWords);
+        }
+
+        // Word aligned blocks are interleaved in place, others behind the previous block
+        if ((outBits & 63) == 0) {
+            rmRunPlan(plan, cb + (size_t)r * cbWords, selected.data(), out + (outBits >> 6));
+        }
+        else {
+            rmRunPlan(plan, cb + (size_t)r * cbWords, selected.data(), interleaved.data());
+            rmCopyBits(out, outBits, interleaved.data(), 0, E);
+        }
+        outBits += E;
+    }
+
+    // Clear the bits after the last block
+    if ((outBits & 63) != 0) {
+        out[outBits >> 6] &= ~0ULL << (64 - (outBits & 63));
+    }
+    return outBits;
+}
@@ -0,0 +1,42 @@
+// rmBatch.h
+
+#ifndef RMBATCH_H
+#define RMBATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "rmKernel.h"
+#include "rmPlan.h"
+
+// Parameters of one transport block
+struct rmTbConfig {
+    int N = 0;        // Code block length
+    int rv = 0;       // Redundancy version (0..3)
+    int Nref = 0;     // Limited buffer size, 0 = full buffer
+    int nlayers = 1;  // Number of transmission layers
+    int Qm = 2;       // Modulation order
+    int C = 1;        // Number of code blocks
+    int G = 0;        // Rate-matched bits of the transport block
+    int F = 0;        // Filler bits of each code block
+};
+
+// Rate matching of whole transport blocks without SystemC. Holds the plan
+// cache and the work buffers, so one object should be kept per thread.
+class rmBatch {
+public:
+    // Rate-match the C code blocks of cfg. cb holds them back to back, each
+    // starting on a word boundary, cbStride words apart (0 = rmNumWords(N)).
+    // The concatenated output (TS 38.212 5.5) is written to out, which must
+    // hold rmNumWords(G + C * nlayers * Qm) words; bits after the output in
+    // its last word are cleared. Returns the number of output bits.
+    int rateMatch(const rmTbConfig& cfg, const uint64_t* cb, uint64_t* out, int cbStride = 0);
+
+    const rmPlanCache& plans() const { return cache; }
+
+private:
+    rmPlanCache cache;
+    std::vector<uint64_t> selected;
+    std::vector<uint64_t> interleaved;
+};
+
+#endif // RMBATCH_H
@@ -0,0 +1,131 @@
+/*
+ * ==============================================
+ * File:        rmBuffer.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Runtime-sized packed circular buffer for one
+ *              code block. Replaces the compile-time
+ *              sc_lv<MAX_FIFO_SIZE> FIFO so that every BG1/BG2
+ *              lifting size up to 66 x 384 bits can be
+ *              simulated.
+ *
+ *  - rmHarqStore keeps the code blocks of each HARQ process
+ *    for retransmissions, within a fixed number of bits, the
+ *    least recently used process evicted first.
+ * ==============================================
+ */
+
+#include "rmBuffer.h"
+#include <algorithm>
+
+void rmCircularBuffer::configure(int N, int beatBits) {
+    blockBits = N;
+    beatWords = beatBits / 64;
+    blockBeats = (N + beatBits - 1) / beatBits;
+
+    // Grow only, a smaller block reuses the storage of a larger one
+    if ((int)words.size() < beatWords * blockBeats) {
+        words.resize(beatWords * blockBeats, 0);
+    }
+    clear();
+}
+
+void rmCircularBuffer::clear() {
+    // Bits of a short block must not leak from the previous codeword
+    std::fill(words.begin(), words.begin() + beatWords * numBeats, 0);
+    numBeats = 0;
+}
+
+void rmCircularBuffer::pushBeat(const uint64_t* beat) {
+    if (full()) {
+        return;
+    }
+    std::copy(beat, beat + beatWords, words.begin() + beatWords * numBeats);
+    ++numBeats;
+}
+
+void rmCircularBuffer::load(const uint64_t* block) {
+    std::copy(block, block + beatWords * blockBeats, words.begin());
+    numBeats = blockBeats;
+}
+
+void rmHarqStore::setCapacity(long long bits) {
+    capacityBits = bits;
+    clear();
+}
+
+void rmHarqStore::clear() {
+    entries.clear();
+    usedWords = 0;
+}
+
+bool rmHarqStore::lookup(int process, int N, int C) {
+    auto it = entries.find(process);
+    if (it == entries.end() || it->second.N != N || it->second.C != C) {
+        ++missCount;
+        return false;
+    }
+    it->second.lastUse = ++useClock;
+    ++hitCount;
+    return true;
+}
+
+bool rmHarqStore::begin(int process, int N, int C, int beatBits) {
+    // The previous codeword of the process is replaced, its storage reused
+    std::vector<uint64_t> storage;
+    auto it = entries.find(process);
+    if (it != entries.end()) {
+        storage.swap(it->second.words);
+        usedWords -= (long long)storage.size();
+        entries.erase(it);
+    }
+
+    int blockWords = (beatBits / 64) * ((N + beatBits - 1) / beatBits);
+    long long words = (long long)blockWords * C;
+    if (64 * words > capacityBits) {
+        return false;
+    }
+
+    // Evict the least recently used processes until the codeword fits
+    while (64 * (usedWords + words) > capacityBits) {
+        auto lru = entries.begin();
+        for (auto e = entries.begin(); e != entries.end(); ++e) {
+            if (e->second.lastUse < lru->second.lastUse) {
+                lru = e;
+            }
+        }
+        usedWords -= (long long)lru->second.words.size();
+        entries.erase(lru);
+        ++evictCount;
+    }
+
+    entry& e = entries[process];
+    e.N = N;
+    e.C = C;
+    e.blockWords = blockWords;
+    e.lastUse = ++useClock;
+    e.words.swap(storage);
+    e.words.resize((size_t)words);
+    usedWords += words;
+    return true;
+}
+
+void rmHarqStore::put(int process, int r, const uint64_t* words) {
+    auto it = entries.find(process);
+    if (it == entries.end() || r < 0 || r >= it->second.C) {
+        return;
+    }
+    entry& e = it->second;
+    std::copy(words, words + e.blockWords, e.words.begin() + (size_t)e.blockWords * r);
+}
+
+const uint64_t* rmHarqStore::block(int process, int r) const {
+    auto it = entries.find(process);
+    if (it == entries.end() || r < 0 || r >= it->second.C) {
+        return nullptr;
+    }
+    return it->second.words.data() + (size_t)it->second.blockWords * r;
+}
@@ -0,0 +1,102 @@
+// rmBuffer.h
+
+#ifndef RMBUFFER_H
+#define RMBUFFER_H
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// Largest LDPC code block: BG1 with Zc = 384
+const int MAX_CB_SIZE = 66 * 384;
+
+// Packed circular buffer holding one code block (TS 38.212 5.4.2.1) as it
+// streams in, one bus beat at a time in the rmKernel bit order. The storage
+// is sized from the configured block length and only ever grows, so it is
+// reused by every following codeword without reallocating.
+class rmCircularBuffer {
+public:
+    // Size the buffer for N-bit code blocks arriving in beatBits-bit beats
+    // (a multiple of 64) and drop the current contents
+    void configure(int N, int beatBits = 128);
+
+    // Drop the current code block, keeping the storage
+    void clear();
+
+    // Append one beat of beatBits / 64 words, the first 64 bits in beat[0]
+    void pushBeat(const uint64_t* beat);
+
+    // Fill the whole code block at once, beatsPerBlock beats from block
+    void load(const uint64_t* block);
+
+    bool full() const { return numBeats >= blockBeats; }
+    bool empty() const { return numBeats == 0; }
+    int beats() const { return numBeats; }
+    int beatsPerBlock() const { return blockBeats; }
+    int length() const { return blockBits; }
+    const uint64_t* data() const { return words.data(); }
+
+private:
+    std::vector<uint64_t> words;
+    int blockBits = 0;   // N
+    int beatWords = 2;   // 64-bit words per beat
+    int blockBeats = 0;  // Beats per code block
+    int numBeats = 0;    // beats received for the current code block
+};
+
+// Default size of the HARQ codeword store in bits (512 KiB)
+const long long RM_HARQ_CAPACITY = 1LL << 22;
+
+// Codewords of the HARQ processes, so that a retransmission with another rv
+// re-runs bit selection on the stored code blocks instead of receiving them
+// again. A process holds the C code blocks of its last transport block, each
+// padded to whole beats as in rmCircularBuffer. The store is bounded in bits:
+// a new codeword evicts the least recently used processes until it fits, and
+// one larger than the whole store is not kept.
+class rmHarqStore {
+public:
+    explicit rmHarqStore(long long capacityBits = RM_HARQ_CAPACITY) : capacityBits(capacityBits) {}
+
+    // Resize the store and drop every codeword, 0 stores nothing
+    void setCapacity(long long bits);
+
+    // Drop every codeword, keeping the counters
+    void clear();
+
+    // Retransmission of C code blocks of N bits: true when the process holds
+    // them, which makes it the most recently used. Counted as a hit or a miss.
+    bool lookup(int process, int N, int C);
+
+    // Replace the codeword of a process by C code blocks of N bits arriving in
+    // beatBits-bit beats. False when it does not fit in the whole store, the
+    // process then holds nothing.
+    bool begin(int process, int N, int C, int beatBits = 128);
+
+    // Store code block r of the codeword begun, beatsPerBlock beats from words
+    void put(int process, int r, const uint64_t* words);
+
+    // Code block r of the codeword of a process, nullptr when it holds none
+    const uint64_t* block(int process, int r) const;
+
+    long long capacity() const { return capacityBits; }
+    long long usedBits() const { return 64 * usedWords; }
+    long long hits() const { return hitCount; }
+    long long misses() const { return missCount; }
+    long long evictions() const { return evictCount; }
+
+private:
+    struct entry {
+        int N = 0;
+        int C = 0;
+        int blockWords = 0;          // Words per code block, whole beats
+        long long lastUse = 0;       // useClock of the last begin or hit
+        std::vector<uint64_t> words;
+    };
+    std::map<int, entry> entries;    // By HARQ process
+    long long capacityBits;
+    long long usedWords = 0;
+    long long useClock = 0;
+    long long hitCount = 0, missCount = 0, evictCount = 0;
+};
+
+#endif // RMBUFFER_H
@@ -0,0 +1,89 @@
+/*
+ * ==============================================
+ * File:        rmDerate.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: De-rate matching kernel. The loops work on
+ *              contiguous runs with no branch per value, so
+ *              the compiler vectorises the saturating adds.
+ *
+ * Variable Descriptions:
+ *  - llr: received soft values, E per code block, interleaved order.
+ *  - e: soft values in bit selection order.
+ *  - soft: Ncb accumulated soft values of the circular buffer.
+ * ==============================================
+ */
+
+#include "rmDerate.h"
+#include "rmSimd.h"
+#include <algorithm>
+#include <type_traits>
+
+template <typename T>
+void rmDeinterleaveScalar(const T* llr, int E, int Qm, T* e) {
+    if (Qm <= 1) {
+        std::copy(llr, llr + E, e);
+        return;
+    }
+
+    // One column at a time: column j takes every Qm-th value from j
+    int rows = E / Qm;
+    for (int j = 0; j < Qm; ++j) {
+        T* col = e + (size_t)j * rows;
+        const T* src = llr + j;
+        for (int i = 0; i < rows; ++i) {
+            col[i] = src[(size_t)i * Qm];
+        }
+    }
+}
+
+template <typename T>
+void rmDeinterleave(const T* llr, int E, int Qm, T* e) {
+    if (std::is_same<T, int8_t>::value && Qm >= 2 && Qm <= 10 && rmHaveSsse3()) {
+        rmDeinterleaveSsse3((const int8_t*)llr, E, Qm, (int8_t*)e);
+        return;
+    }
+    rmDeinterleaveScalar(llr, E, Qm, e);
+}
+
+template <typename T>
+void rmCombine(const rmPlan& plan, const T* e, int16_t* soft) {
+    int k = 0;
+    for (const rmRun& run : plan.runs) {
+        int16_t* dst = soft + run.pos;
+        const T* src = e + k;
+        for (int t = 0; t < run.len; ++t) {
+            int v = (int)dst[t] + (int)src[t];
+            dst[t] = (int16_t)std::min(std::max(v, (int)INT16_MIN), (int)INT16_MAX);
+        }
+        k += run.len;
+    }
+}
+
+template <typename T>
+void rmDerateMatch(const rmPlan& plan, const T* llr, T* scratch, int16_t* soft) {
+    rmDeinterleave(llr, plan.E, plan.Qm, scratch);
+    rmCombine(plan, scratch, soft);
+}
+
+template void rmDeinterleaveScalar<int8_t>(const int8_t*, int, int, int8_t*);
+template void rmDeinterleaveScalar<int16_t>(const int16_t*, int, int, int16_t*);
+template void rmDeinterleave<int8_t>(const int8_t*, int, int, int8_t*);
+template void rmDeinterleave<int16_t>(const int16_t*, int, int, int16_t*);
+template void rmCombine<int8_t>(const rmPlan&, const int8_t*, int16_t*);
+template void rmCombine<int16_t>(const rmPlan&, const int16_t*, int16_t*);
+template void rmDerateMatch<int8_t>(const rmPlan&, const int8_t*, int8_t*, int16_t*);
+template void rmDerateMatch<int16_t>(const rmPlan&, const int16_t*, int16_t*, int16_t*);
+
+rmHarqPool::rmHarqPool(int processes, int codeBlocks, int cbSize)
+    : numProcesses(processes), numBlocks(codeBlocks), blockSize(cbSize),
+      soft((size_t)processes * codeBlocks * cbSize, 0) {
+}
+
+void rmHarqPool::clear(int process, int r) {
+    int16_t* b = buffer(process, r);
+    std::fill(b, b + blockSize, 0);
+}
@@ -0,0 +1,58 @@
+// rmDerate.h
+
+#ifndef RMDERATE_H
+#define RMDERATE_H
+
+#include <cstdint>
+#include <vector>
+#include "rmPlan.h"
+
+// Receive side of rate matching: E soft values (LLRs) of one code block
+// are de-interleaved and accumulated into the Ncb soft values of its
+// circular buffer, positions given by the same rmPlan as the transmit side.
+// Accumulation saturates at the int16_t range, so repeated bits and HARQ
+// retransmissions with any rv combine in place. Filler positions are not
+// touched.
+
+// Inverse of rmInterleaveBits: e[j * (E / Qm) + i] = llr[i * Qm + j].
+// int8_t uses the SIMD kernel of rmSimd.h when the CPU has it.
+template <typename T>
+void rmDeinterleave(const T* llr, int E, int Qm, T* e);
+
+// Portable de-interleaving, same result
+template <typename T>
+void rmDeinterleaveScalar(const T* llr, int E, int Qm, T* e);
+
+// soft[pos] += e[k] along the selection runs of plan, saturating
+template <typename T>
+void rmCombine(const rmPlan& plan, const T* e, int16_t* soft);
+
+// De-interleave llr into scratch (plan.E values) and combine into soft
+template <typename T>
+void rmDerateMatch(const rmPlan& plan, const T* llr, T* scratch, int16_t* soft);
+
+// Soft buffers of every HARQ process and code block, allocated once
+class rmHarqPool {
+public:
+    rmHarqPool(int processes, int codeBlocks, int cbSize);
+
+    // Soft buffer of code block r of a HARQ process, cbSize values
+    int16_t* buffer(int process, int r) {
+        return soft.data() + ((size_t)process * numBlocks + r) * blockSize;
+    }
+
+    // Drop the soft values of a code block, before a new transport block
+    void clear(int process, int r);
+
+    int processes() const { return numProcesses; }
+    int codeBlocks() const { return numBlocks; }
+    int cbSize() const { return blockSize; }
+
+private:
+    int numProcesses;
+    int numBlocks;
+    int blockSize;
+    std::vector<int16_t> soft;
+};
+
+#endif // RMDERATE_H
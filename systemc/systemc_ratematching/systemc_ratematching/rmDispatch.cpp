@@ -0,0 +1,239 @@
+/*
+ * ==============================================
+ * File:        rmDispatch.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Bit interleaving kernels specialised at
+ *              compile time per modulation order, and the
+ *              table that picks one per configuration.
+ *
+ *  - 64 rows of the Qm columns fill exactly Qm output words,
+ *    built in registers and stored whole.
+ *  - Qm 2 and 4 spread each column with constant shift and
+ *    mask steps, Qm 8 is one 8x8 transpose per word.
+ *  - Qm 6 and 10 go through 8x8 transposes, then shrink each
+ *    8-bit row to Qm bits with constant shift and mask steps.
+ *  - With BMI2 the table takes the rmSimd kernels that have
+ *    the pdep masks as immediates instead.
+ * ==============================================
+ */
+
+#include "rmDispatch.h"
+#include "rmKernel.h"
+#include "rmSimd.h"
+#include <algorithm>
+
+// OR the n (<= 64) right-aligned bits of v into w at MSB-first bit position p
+static inline void orBits(uint64_t* w, int p, uint64_t v, int n) {
+    int shift = 64 - (p & 63) - n;
+    if (shift >= 0) {
+        w[p >> 6] |= v << shift;
+    }
+    else {
+        w[p >> 6] |= v >> -shift;
+        w[(p >> 6) + 1] |= v << (64 + shift);
+    }
+}
+
+// Bit k of x moves to bit 2k
+static inline uint64_t spread2(uint64_t x) {
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFULL;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFULL;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | (x << 2)) & 0x3333333333333333ULL;
+    x = (x | (x << 1)) & 0x5555555555555555ULL;
+    return x;
+}
+
+// Bit k of x moves to bit 4k
+static inline uint64_t spread4(uint64_t x) {
+    x = (x | (x << 24)) & 0x000000FF000000FFULL;
+    x = (x | (x << 12)) & 0x000F000F000F000FULL;
+    x = (x | (x << 6)) & 0x0303030303030303ULL;
+    x = (x | (x << 3)) & 0x1111111111111111ULL;
+    return x;
+}
+
+// Lanes of 2 * lane bits holding valid bits at the top of each half: move
+// the lower half's bits up against the upper half's
+static inline uint64_t packLanes(uint64_t x, int lane, int valid, uint64_t upper) {
+    return (x & upper) | ((x & ~upper) << (lane - valid));
+}
+
+// Rows 0..7 of columns c..c+7 as one byte per row, row 0 in the top byte
+static inline uint64_t transposeRows(const uint64_t* col, int c, int columns, int g) {
+    uint64_t m = 0;
+    for (int k = 0; k < columns; ++k) {
+        m |= ((col[c + k] >> (56 - 8 * g)) & 0xFF) << (56 - 8 * k);
+    }
+    return rmTranspose8x8(m);
+}
+
+// Output words of 64 rows, col[j] holding rows 0..63 of column j MSB first.
+// Qm <= 8: 8 rows are one transpose, whose bytes then shrink to Qm bits.
+template <int QM>
+struct rmInterleaveGroup {
+    static void run(const uint64_t* col, uint64_t* w) {
+        for (int k = 0; k < QM; ++k) {
+            w[k] = 0;
+        }
+        for (int g = 0; g < 8; ++g) {
+            uint64_t x = transposeRows(col, 0, QM, g);
+            x = packLanes(x, 8, QM, 0xFF00FF00FF00FF00ULL);
+            x = packLanes(x, 16, 2 * QM, 0xFFFF0000FFFF0000ULL);
+            x = packLanes(x, 32, 4 * QM, 0xFFFFFFFF00000000ULL);
+            orBits(w, 8 * QM * g, x >> (64 - 8 * QM), 8 * QM);
+        }
+    }
+};
+
+template <>
+struct rmInterleaveGroup<1> {
+    static void run(const uint64_t* col, uint64_t* w) {
+        w[0] = col[0];
+    }
+};
+
+template <>
+struct rmInterleaveGroup<2> {
+    static void run(const uint64_t* col, uint64_t* w) {
+        // Word k holds rows 32k..32k+31, column 0 in the upper bit of each pair
+        for (int k = 0; k < 2; ++k) {
+            int s = 32 - 32 * k;
+            w[k] = (spread2((col[0] >> s) & 0xFFFFFFFFULL) << 1) | spread2((col[1] >> s) & 0xFFFFFFFFULL);
+        }
+    }
+};
+
+template <>
+struct rmInterleaveGroup<4> {
+    static void run(const uint64_t* col, uint64_t* w) {
+        // Word k holds rows 16k..16k+15, column j at bit 3 - j of each nibble
+        for (int k = 0; k < 4; ++k) {
+            int s = 48 - 16 * k;
+            w[k] = (spread4((col[0] >> s) & 0xFFFF) << 3) | (spread4((col[1] >> s) & 0xFFFF) << 2) |
+                   (spread4((col[2] >> s) & 0xFFFF) << 1) | spread4((col[3] >> s) & 0xFFFF);
+        }
+    }
+};
+
+// Bytes of the top halves of a and b interleaved, a first
+static inline uint64_t interleaveBytes(uint64_t a, uint64_t b) {
+    a >>= 32;
+    b >>= 32;
+    a = (a | (a << 16)) & 0x0000FFFF0000FFFFULL;
+    a = (a | (a << 8)) & 0x00FF00FF00FF00FFULL;
+    b = (b | (b << 16)) & 0x0000FFFF0000FFFFULL;
+    b = (b | (b << 8)) & 0x00FF00FF00FF00FFULL;
+    return (a << 8) | b;
+}
+
+template <>
+struct rmInterleaveGroup<10> {
+    static void run(const uint64_t* col, uint64_t* w) {
+        // 8 rows are a transpose of columns 0..7 and one of columns 8..9;
+        // 4 rows of both make 16-bit lanes with 10 bits each, packed to 40 bits
+        for (int k = 0; k < 10; ++k) {
+            w[k] = 0;
+        }
+        for (int g = 0; g < 8; ++g) {
+            uint64_t t0 = transposeRows(col, 0, 8, g);
+            uint64_t t1 = transposeRows(col, 8, 2, g);
+            for (int h = 0; h < 2; ++h) {
+                uint64_t x = interleaveBytes(t0 << (32 * h), t1 << (32 * h));
+                x = packLanes(x, 16, 10, 0xFFFF0000FFFF0000ULL);
+                x = packLanes(x, 32, 20, 0xFFFFFFFF00000000ULL);
+                orBits(w, 80 * g + 40 * h, x >> 24, 40);
+            }
+        }
+    }
+};
+
+template <>
+struct rmInterleaveGroup<8> {
+    static void run(const uint64_t* col, uint64_t* w) {
+        // Word g holds rows 8g..8g+7, one byte each
+        for (int g = 0; g < 8; ++g) {
+            int s = 56 - 8 * g;
+            uint64_t m = 0;
+            for (int c = 0; c < 8; ++c) {
+                m |= ((col[c] >> s) & 0xFF) << (56 - 8 * c);
+            }
+            w[g] = rmTranspose8x8(m);
+        }
+    }
+};
+
+template <int QM>
+void rmInterleaveBitsFixed(const uint64_t* e, int E, uint64_t* out) {
+    int rows = E / QM;
+    int nWords = rmNumWords(E);
+    uint64_t col[QM];
+    uint64_t w[QM];
+    int o = 0;
+
+    for (int i0 = 0; i0 < rows; i0 += 64) {
+        int n = std::min(64, rows - i0);
+
+        // Next 64 rows of every column, rows past the end read as 0
+        for (int j = 0; j < QM; ++j) {
+            col[j] = rmReadBits(e, j * rows + i0, n);
+        }
+        rmInterleaveGroup<QM>::run(col, w);
+
+        // Only the last group can be partial
+        int words = (n * QM + 63) / 64;
+        std::copy(w, w + words, out + o);
+        o += words;
+    }
+    std::fill(out + o, out + nWords, 0);
+}
+
+template void rmInterleaveBitsFixed<1>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsFixed<2>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsFixed<4>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsFixed<6>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsFixed<8>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsFixed<10>(const uint64_t*, int, uint64_t*);
+
+// Generic kernel with the Qm of the table entry
+template <int QM>
+static void interleaveGeneric(const uint64_t* e, int E, uint64_t* out) {
+    rmInterleaveBits(e, E, QM, out);
+}
+
+rmInterleaveFn rmInterleaveKernel(int Qm) {
+    static const rmInterleaveFn table[11] = {
+        nullptr,
+        rmInterleaveBitsFixed<1>,
+        rmInterleaveBitsFixed<2>,
+        interleaveGeneric<3>,
+        rmInterleaveBitsFixed<4>,
+        interleaveGeneric<5>,
+        rmInterleaveBitsFixed<6>,
+        interleaveGeneric<7>,
+        rmInterleaveBitsFixed<8>,
+        interleaveGeneric<9>,
+        rmInterleaveBitsFixed<10>
+    };
+    static const rmInterleaveFn tableBmi2[11] = {
+        nullptr,
+        rmInterleaveBitsFixed<1>,
+        rmInterleaveBitsBmi2Fixed<2>,
+        interleaveGeneric<3>,
+        rmInterleaveBitsBmi2Fixed<4>,
+        interleaveGeneric<5>,
+        rmInterleaveBitsBmi2Fixed<6>,
+        interleaveGeneric<7>,
+        rmInterleaveBitsBmi2Fixed<8>,
+        interleaveGeneric<9>,
+        rmInterleaveBitsBmi2Fixed<10>
+    };
+    if (Qm < 1 || Qm > 10) {
+        return nullptr;
+    }
+    return rmHaveBmi2() ? tableBmi2[Qm] : table[Qm];
+}
@@ -0,0 +1,26 @@
+// rmDispatch.h
+
+#ifndef RMDISPATCH_H
+#define RMDISPATCH_H
+
+#include <cstdint>
+
+// Bit interleaving kernels compiled once per modulation order, so the column
+// loops are unrolled and the shifts and masks are constants. A kernel is
+// picked once per configuration (see rmPlan) instead of branching on Qm in
+// every block.
+
+// Bit interleaving (TS 38.212 5.4.2.2) of E bits for a fixed Qm
+typedef void (*rmInterleaveFn)(const uint64_t* e, int E, uint64_t* out);
+
+// Kernel specialised for QM, one of 1, 2, 4, 6, 8, 10. Same result as
+// rmInterleaveBitsScalar; bits of out beyond E are cleared.
+template <int QM>
+void rmInterleaveBitsFixed(const uint64_t* e, int E, uint64_t* out);
+
+// Kernel for Qm from the dispatch table: rmInterleaveBitsBmi2Fixed when the
+// CPU has BMI2, rmInterleaveBitsFixed otherwise, and rmInterleaveBits for odd
+// Qm above 1. nullptr outside 1..10.
+rmInterleaveFn rmInterleaveKernel(int Qm);
+
+#endif // RMDISPATCH_H
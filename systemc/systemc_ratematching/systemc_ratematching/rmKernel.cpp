@@ -0,0 +1,178 @@
+/*
+ * ==============================================
+ * File:        rmKernel.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: SystemC-free rate matching kernel working on
+ *              packed 64-bit words. Bit selection copies
+ *              whole runs of the circular buffer with word
+ *              shifts, and bit interleaving is done with 8x8
+ *              bit-matrix transposes instead of one bit at a
+ *              time.
+ *
+ * Variable Descriptions:
+ *  - cb: packed code block (circular buffer), first Ncb bits are used.
+ *  - k0: starting position of the redundancy version in the buffer.
+ *  - E: number of rate-matched output bits.
+ *  - Qm: modulation order, number of interleaver columns.
+ * ==============================================
+ */
+
+#include "rmKernel.h"
+#include "rmSimd.h"
+#include <algorithm>
+
+// Appends MSB-first bit groups to a packed output buffer
+struct rmBitWriter {
+    uint64_t* out;
+    uint64_t acc;
+    int fill;
+    int word;
+
+    explicit rmBitWriter(uint64_t* o) : out(o), acc(0), fill(0), word(0) {}
+
+    // v holds n (<= 64) bits right-aligned, upper bits clear
+    void put(uint64_t v, int n) {
+        int space = 64 - fill;
+        if (n < space) {
+            acc |= v << (space - n);
+            fill += n;
+        }
+        else {
+            out[word++] = acc | (v >> (n - space));
+            fill = n - space;
+            acc = (fill != 0) ? v << (64 - fill) : 0;
+        }
+    }
+
+    void flush() {
+        if (fill != 0) {
+            out[word++] = acc;
+            acc = 0;
+            fill = 0;
+        }
+    }
+};
+
+int rmNumWords(int nbits) {
+    return (nbits + 63) / 64;
+}
+
+void rmCopyBits(uint64_t* dst, int dstPos, const uint64_t* src, int srcPos, int len) {
+    while (len > 0) {
+        int off = dstPos & 63;
+        int n = std::min(len, 64 - off);
+        uint64_t v = rmReadBits(src, srcPos, n);
+        uint64_t mask = (~0ULL << (64 - n)) >> off;
+        uint64_t& w = dst[dstPos >> 6];
+        w = (w & ~mask) | ((v >> off) & mask);
+        dstPos += n;
+        srcPos += n;
+        len -= n;
+    }
+}
+
+int rmBlockE(int G, int C, int r, int nlayers, int Qm) {
+    int nq = nlayers * Qm;
+    if (nq <= 0 || C <= 0) {
+        return 0;
+    }
+
+    // r <= C - mod(G / (nlayers * Qm), C) - 1, with G / (nlayers * Qm) taken as a real number
+    int q = G / nq;
+    int threshold = C - (q % C) - 1 - ((G % nq != 0) ? 1 : 0);
+    if (r <= threshold) {
+        return nq * (G / (nq * C));
+    }
+    return nq * ((G + nq * C - 1) / (nq * C));
+}
+
+void rmSelectBits(const uint64_t* cb, int Ncb, int k0, int E, uint64_t* e) {
+    if (E <= 0 || Ncb <= 0) {
+        return;
+    }
+
+    // Each pass around the circular buffer is one contiguous copy
+    int k = 0;
+    int pos = k0 % Ncb;
+    while (k < E) {
+        int n = std::min(E - k, Ncb - pos);
+        rmCopyBits(e, k, cb, pos, n);
+        k += n;
+        pos = 0;
+    }
+}
+
+void rmInterleaveBitsScalar(const uint64_t* e, int E, int Qm, uint64_t* out) {
+    int nWords = rmNumWords(E);
+    if (Qm <= 1) {
+        // A single column is the identity permutation
+        std::fill(out, out + nWords, 0);
+        rmCopyBits(out, 0, e, 0, E);
+        return;
+    }
+
+    int rows = E / Qm;
+    int bands = (Qm + 7) / 8; // groups of up to 8 columns per transpose
+    uint64_t col[16];
+    uint64_t t[2];
+    rmBitWriter writer(out);
+
+    for (int i0 = 0; i0 < rows; i0 += 64) {
+        int n = std::min(64, rows - i0);
+
+        // Next 64 rows of every column
+        for (int j = 0; j < Qm; ++j) {
+            col[j] = rmReadBits(e, j * rows + i0, n);
+        }
+
+        // Transpose 8 rows x 8 columns at a time
+        for (int g = 0; g * 8 < n; ++g) {
+            int shift = 56 - 8 * g;
+            int nr = std::min(8, n - 8 * g);
+
+            for (int b = 0; b < bands; ++b) {
+                uint64_t m = 0;
+                for (int c = 0; c < 8 && b * 8 + c < Qm; ++c) {
+                    m |= ((col[b * 8 + c] >> shift) & 0xFF) << (56 - 8 * c);
+                }
+                t[b] = rmTranspose8x8(m);
+            }
+
+            if (Qm == 8 && nr == 8) {
+                writer.put(t[0], 64);
+                continue;
+            }
+
+            // Byte r of the transposed band holds the column bits of row r
+            for (int r = 0; r < nr; ++r) {
+                uint64_t bits = 0;
+                for (int b = 0; b < bands; ++b) {
+                    int w = std::min(8, Qm - b * 8);
+                    bits = (bits << w) | (((t[b] >> (56 - 8 * r)) & 0xFF) >> (8 - w));
+                }
+                writer.put(bits, Qm);
+            }
+        }
+    }
+    writer.flush();
+
+    // Clear any words the writer did not reach
+    std::fill(out + writer.word, out + nWords, 0);
+}
+
+void rmInterleaveBits(const uint64_t* e, int E, int Qm, uint64_t* out) {
+    if (Qm >= 2 && Qm <= 10 && rmHaveBmi2()) {
+        rmInterleaveBitsBmi2(e, E, Qm, out);
+        return;
+    }
+    rmInterleaveBitsScalar(e, E, Qm, out);
+}
+
+void rmRateMatch(const uint64_t* cb, int Ncb, int k0, int E, int Qm, uint64_t* scratch, uint64_t* out) {
+    rmSelectBits(cb, Ncb, k0, E, scratch);
+    rmInterleaveBits(scratch, E, Qm, out);
+}
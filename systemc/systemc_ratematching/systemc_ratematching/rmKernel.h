@@ -0,0 +1,63 @@
+// rmKernel.h
+
+#ifndef RMKERNEL_H
+#define RMKERNEL_H
+
+#include <cstdint>
+
+// Packed bit layout used by the kernel: stream bit n lives in word n / 64,
+// MSB first (stream bit 0 is bit 63 of word 0). This is the same order in
+// which bits travel on the 128-bit buses, so one bus beat is two words.
+
+// Number of 64-bit words needed to hold nbits bits
+int rmNumWords(int nbits);
+
+// Read n (<= 64) bits starting at bit pos, returned MSB-aligned
+inline uint64_t rmReadBits(const uint64_t* src, int pos, int n) {
+    if (n <= 0) {
+        return 0;
+    }
+    int w = pos >> 6;
+    int s = pos & 63;
+    uint64_t v = src[w] << s;
+    if (s != 0 && s + n > 64) {
+        v |= src[w + 1] >> (64 - s);
+    }
+    return (n == 64) ? v : v & (~0ULL << (64 - n));
+}
+
+// Copy len bits from src[srcPos..] to dst[dstPos..], other dst bits untouched
+void rmCopyBits(uint64_t* dst, int dstPos, const uint64_t* src, int srcPos, int len);
+
+// Transpose of an 8x8 bit matrix stored one row per byte, row 0 in the top byte
+inline uint64_t rmTranspose8x8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// Rate matching output length E of code block r when all C code blocks of
+// the transport block are scheduled (TS 38.212 5.4.2.1), G = total bits
+int rmBlockE(int G, int C, int r, int nlayers, int Qm);
+
+// Bit selection (TS 38.212 5.4.2.1): E bits read circularly from the first
+// Ncb bits of cb, starting at k0
+void rmSelectBits(const uint64_t* cb, int Ncb, int k0, int E, uint64_t* e);
+
+// Bit interleaving (TS 38.212 5.4.2.2): out[i * Qm + j] = e[j * (E / Qm) + i].
+// Uses the SIMD kernel of rmSimd.h when the CPU has it.
+void rmInterleaveBits(const uint64_t* e, int E, int Qm, uint64_t* out);
+
+// Portable bit interleaving with 8x8 transposes, same result
+void rmInterleaveBitsScalar(const uint64_t* e, int E, int Qm, uint64_t* out);
+
+// Bit selection followed by bit interleaving. scratch and out must hold
+// rmNumWords(E) words each; bits of out beyond E are cleared.
+void rmRateMatch(const uint64_t* cb, int Ncb, int k0, int E, int Qm, uint64_t* scratch, uint64_t* out);
+
+#endif // RMKERNEL_H
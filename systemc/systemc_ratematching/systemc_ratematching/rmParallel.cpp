@@ -0,0 +1,107 @@
+/*
+ * ==============================================
+ * File:        rmParallel.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Parallel batch rate matching. Plans and
+ *              output offsets are set up on the calling
+ *              thread, then the code blocks run on the
+ *              thread pool. A block only writes the output
+ *              words it fully owns; the words it shares with
+ *              its neighbours are merged once all blocks are
+ *              done.
+ * ==============================================
+ */
+
+#include "rmParallel.h"
+#include <algorithm>
+
+rmParallelBatch::rmParallelBatch(int threads)
+    : pool(threads), selected(pool.size()), interleaved(pool.size()) {
+}
+
+void rmParallelBatch::run(std::vector<rmTbJob>& jobs) {
+
+    // Plans, output offsets and work buffer sizes, in job order
+    blocks.clear();
+    int maxWords = 0;
+    for (rmTbJob& job : jobs) {
+        const rmTbConfig& cfg = job.cfg;
+        int C = std::max(cfg.C, 1);
+        int cbWords = rmNumWords(cfg.N);
+        int offset = 0;
+        for (int r = 0; r < C; ++r) {
+            int E = rmBlockE(cfg.G, C, r, cfg.nlayers, cfg.Qm);
+            Block b;
+            b.plan = &cache.get(cfg.N, cfg.rv, cfg.Nref, E, cfg.Qm, cfg.F);
+            b.cb = job.cb + (size_t)r * cbWords;
+            b.out = job.out;
+            b.offset = offset;
+            blocks.push_back(b);
+            offset += E;
+            maxWords = std::max(maxWords, rmNumWords(E));
+        }
+        job.outBits = offset;
+    }
+    for (int w = 0; w < pool.size(); ++w) {
+        if ((int)selected[w].size() < maxWords) {
+            selected[w].resize(maxWords);
+            interleaved[w].resize(maxWords);
+        }
+    }
+
+    pool.parallelFor((int)blocks.size(), [this](int i, int worker) {
+        runBlock(blocks[i], worker);
+    });
+
+    // Merge the shared words: clear them all, then add the bits of each block
+    for (const Block& b : blocks) {
+        for (int k = 0; k < 2; ++k) {
+            if (b.edgeWord[k] >= 0) {
+                b.out[b.edgeWord[k]] = 0;
+            }
+        }
+    }
+    for (const Block& b : blocks) {
+        for (int k = 0; k < 2; ++k) {
+            if (b.edgeWord[k] >= 0) {
+                b.out[b.edgeWord[k]] |= b.edge[k];
+            }
+        }
+    }
+}
+
+void rmParallelBatch::runBlock(Block& b, int worker) {
+    const rmPlan& plan = *b.plan;
+    uint64_t* e = interleaved[worker].data();
+    rmRunPlan(plan, b.cb, selected[worker].data(), e);
+
+    int begin = b.offset;
+    int end = b.offset + plan.E;
+    int firstFull = (begin + 63) / 64;   // Words [firstFull, lastFull) belong to this block only
+    int lastFull = end / 64;
+
+    if (firstFull < lastFull) {
+        rmCopyBits(b.out, firstFull * 64, e, firstFull * 64 - begin, (lastFull - firstFull) * 64);
+    }
+
+    // First word, shared with the previous block
+    b.edgeWord[0] = -1;
+    if ((begin & 63) != 0) {
+        int n = std::min(end, firstFull * 64) - begin;
+        b.edge[0] = 0;
+        rmCopyBits(&b.edge[0], begin & 63, e, 0, n);
+        b.edgeWord[0] = begin / 64;
+    }
+
+    // Last word, shared with the next block, unless the block ends in its first word
+    b.edgeWord[1] = -1;
+    if ((end & 63) != 0 && lastFull >= firstFull) {
+        b.edge[1] = 0;
+        rmCopyBits(&b.edge[1], 0, e, lastFull * 64 - begin, end & 63);
+        b.edgeWord[1] = lastFull;
+    }
+}
@@ -0,0 +1,56 @@
+// rmParallel.h
+
+#ifndef RMPARALLEL_H
+#define RMPARALLEL_H
+
+#include <cstdint>
+#include <vector>
+#include "rmBatch.h"
+#include "rmThreadPool.h"
+
+// One transport block of a parallel batch, buffers as for rmBatch::rateMatch()
+struct rmTbJob {
+    rmTbConfig cfg;
+    const uint64_t* cb = nullptr;   // C code blocks, rmNumWords(N) words each
+    uint64_t* out = nullptr;        // Concatenated output
+    int outBits = 0;                // Set by run(): number of output bits
+};
+
+// Rate matching of many transport blocks, with the code blocks of all of
+// them spread across a thread pool. Every code block has a fixed output
+// offset, computed before any work starts, so the output is the same
+// whatever the number of threads and the order they run in.
+class rmParallelBatch {
+public:
+    // threads = 0 uses one worker per hardware thread
+    explicit rmParallelBatch(int threads = 0);
+
+    int threads() const { return pool.size(); }
+
+    void run(std::vector<rmTbJob>& jobs);
+
+    const rmPlanCache& plans() const { return cache; }
+
+private:
+    // One code block of the batch
+    struct Block {
+        const rmPlan* plan;
+        const uint64_t* cb;
+        uint64_t* out;
+        int offset;               // First output bit of the block in out
+        uint64_t edge[2];         // Output bits of the partly owned first and last words
+        int edgeWord[2];          // Index of those words in out, -1 = none
+    };
+
+    rmThreadPool pool;
+    rmPlanCache cache;
+    std::vector<Block> blocks;
+
+    // Work buffers of each worker, grown only
+    std::vector<std::vector<uint64_t>> selected;
+    std::vector<std::vector<uint64_t>> interleaved;
+
+    void runBlock(Block& b, int worker);
+};
+
+#endif // RMPARALLEL_H
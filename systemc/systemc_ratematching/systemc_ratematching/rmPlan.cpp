@@ -0,0 +1,161 @@
+/*
+ * ==============================================
+ * File:        rmPlan.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Rate matching plans. The base graph, lifting
+ *              size, soft buffer size, k0 and the bit selection
+ *              runs of a configuration are computed once with
+ *              integer arithmetic and cached, so the per block
+ *              work is only the bit copies. Filler bits are
+ *              skipped as a range rather than tested per bit,
+ *              and the interleaving kernel for Qm is looked up
+ *              once in the rmDispatch table. The required prefix
+ *              table tells how much of the code block each
+ *              output word depends on, for cut-through output.
+ * ==============================================
+ */
+
+#include "rmPlan.h"
+#include "rmKernel.h"
+#include <algorithm>
+#include <iterator>
+
+// Lifting sizes Zc of TS 38.212 Table 5.3.2-1
+static const int ZcVec[] = {
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+    18, 20, 22, 24, 26, 28, 30, 32, 36, 40, 44, 48, 52,
+    56, 60, 64, 72, 80, 88, 96, 104, 112, 120, 128, 144,
+    160, 176, 192, 208, 224, 240, 256, 288, 320, 352, 384
+};
+
+// k0 numerators of TS 38.212 Table 5.4.2.1-2, per base graph and rv
+static const int k0Num[2][4] = {
+    { 0, 17, 33, 56 },  // BG1, N = 66 Zc
+    { 0, 13, 25, 43 }   // BG2, N = 50 Zc
+};
+
+const std::vector<int>& rmLiftingSizes() {
+    static const std::vector<int> sizes(std::begin(ZcVec), std::end(ZcVec));
+    return sizes;
+}
+
+int rmLiftingSize(int N, int& bgn) {
+    bgn = 2;
+    if (N % 66 == 0) {
+        for (int Zc : ZcVec) {
+            if (N == Zc * 66) {
+                bgn = 1;
+                return Zc;
+            }
+        }
+    }
+    return N / 50;
+}
+
+size_t rmPlanKeyHash::operator()(const rmPlanKey& k) const {
+    uint64_t h = (uint64_t)(uint32_t)k.N;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint32_t)k.rv;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint32_t)k.Nref;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint32_t)k.E;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint32_t)k.Qm;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint32_t)k.F;
+    return (size_t)(h ^ (h >> 32));
+}
+
+rmPlan rmMakePlan(int N, int rv, int Nref, int E, int Qm, int F) {
+    rmPlan plan;
+    plan.N = N;
+    plan.E = E;
+    plan.Qm = Qm;
+    plan.F = F;
+    plan.interleave = rmInterleaveKernel(Qm);
+
+    // Base graph 1 when N is 66 times a lifting size, base graph 2 otherwise
+    plan.Zc = rmLiftingSize(N, plan.bgn);
+
+    // Get code block soft buffer size
+    plan.Ncb = (Nref != 0) ? std::min(N, Nref) : N;
+
+    // Get starting position in circular buffer, floor(num * Ncb / N) * Zc
+    if (N > 0) {
+        plan.k0 = (int)((long long)k0Num[plan.bgn - 1][rv & 3] * plan.Ncb / N) * plan.Zc;
+    }
+
+    // Filler bits sit just before the parity bits, K = 22 Zc (BG1) or 10 Zc (BG2)
+    int K = ((plan.bgn == 1) ? 22 : 10) * plan.Zc;
+    int fillEnd = std::min(std::max(K - 2 * plan.Zc, 0), plan.Ncb);
+    int fillStart = std::min(std::max(K - 2 * plan.Zc - F, 0), fillEnd);
+
+    // Each pass around the circular buffer is at most two contiguous runs,
+    // one each side of the filler bits
+    if (plan.Ncb - (fillEnd - fillStart) > 0) {
+        int k = 0;
+        int pos = plan.k0 % plan.Ncb;
+        while (k < E) {
+            if (pos >= fillStart && pos < fillEnd) {
+                pos = fillEnd;
+            }
+            if (pos >= plan.Ncb) {
+                pos = 0;
+                continue;
+            }
+            int end = (pos < fillStart) ? fillStart : plan.Ncb;
+            int n = std::min(E - k, end - pos);
+            plan.runs.push_back({ pos, n });
+            k += n;
+            pos += n;
+        }
+    }
+
+    // Required prefix: bit k of e is row k % rows, column k / rows of the
+    // interleaver, output bit row * Qm + column
+    int cols = std::max(Qm, 1);
+    int rows = E / cols;
+    plan.prefix.assign(rmNumWords(E), 0);
+    int k = 0;
+    for (const rmRun& run : plan.runs) {
+        for (int n = 0; n < run.len && k < rows * cols; ++n, ++k) {
+            int q = (k % rows) * cols + k / rows;
+            plan.prefix[q >> 6] = std::max(plan.prefix[q >> 6], run.pos + n + 1);
+        }
+    }
+    for (size_t t = 1; t < plan.prefix.size(); ++t) {
+        plan.prefix[t] = std::max(plan.prefix[t], plan.prefix[t - 1]);
+    }
+    return plan;
+}
+
+int rmRequiredBits(const rmPlan& plan, int bits) {
+    bits = std::min(bits, plan.E);
+    return (bits > 0) ? plan.prefix[(bits - 1) >> 6] : 0;
+}
+
+void rmRunPlan(const rmPlan& plan, const uint64_t* cb, uint64_t* scratch, uint64_t* out) {
+    int k = 0;
+    for (const rmRun& run : plan.runs) {
+        rmCopyBits(scratch, k, cb, run.pos, run.len);
+        k += run.len;
+    }
+    if (plan.interleave) {
+        plan.interleave(scratch, plan.E, out);
+    }
+    else {
+        rmInterleaveBits(scratch, plan.E, plan.Qm, out);
+    }
+}
+
+const rmPlan& rmPlanCache::get(int N, int rv, int Nref, int E, int Qm, int F) {
+    rmPlanKey key = { N, rv, Nref, E, Qm, F };
+
+    auto it = plans.find(key);
+    if (it != plans.end()) {
+        ++numHits;
+        return it->second;
+    }
+    ++numMisses;
+    return plans.emplace(key, rmMakePlan(N, rv, Nref, E, Qm, F)).first->second;
+}
@@ -0,0 +1,80 @@
+// rmPlan.h
+
+#ifndef RMPLAN_H
+#define RMPLAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "rmDispatch.h"
+
+// One contiguous copy of bit selection: len bits from cb[pos..] into e
+struct rmRun {
+    int pos;
+    int len;
+};
+
+// Parameters a plan depends on
+struct rmPlanKey {
+    int N, rv, Nref, E, Qm, F;
+
+    bool operator==(const rmPlanKey& o) const {
+        return N == o.N && rv == o.rv && Nref == o.Nref && E == o.E && Qm == o.Qm && F == o.F;
+    }
+};
+
+struct rmPlanKeyHash {
+    size_t operator()(const rmPlanKey& k) const;
+};
+
+// Everything rate matching needs for one rmPlanKey, computed once with
+// integer arithmetic (TS 38.212 5.4.2.1)
+struct rmPlan {
+    int N = 0;         // Code block length
+    int bgn = 0;       // LDPC base graph, 1 or 2
+    int Zc = 0;        // Lifting size
+    int Ncb = 0;       // Soft buffer size
+    int k0 = 0;        // Starting position of the redundancy version
+    int E = 0;         // Rate matching output length
+    int Qm = 0;        // Modulation order
+    int F = 0;         // Filler bits, skipped at [K - 2Zc - F, K - 2Zc) of the buffer
+    std::vector<rmRun> runs;  // Bit selection as runs around the circular buffer
+    rmInterleaveFn interleave = nullptr;  // Bit interleaving kernel for Qm, see rmInterleaveKernel
+    std::vector<int> prefix;  // prefix[t]: code block bits that output bits [0, 64 (t + 1)) depend on
+};
+
+// Lifting sizes Zc of TS 38.212 Table 5.3.2-1, ascending
+const std::vector<int>& rmLiftingSizes();
+
+// Lifting size of a code block length: base graph 1 when N is 66 Zc, base
+// graph 2 with N / 50 otherwise
+int rmLiftingSize(int N, int& bgn);
+
+// Build the plan of one code block with F filler bits (K - K')
+rmPlan rmMakePlan(int N, int rv, int Nref, int E, int Qm, int F = 0);
+
+// Leading code block bits the first bits output bits of plan depend on, the
+// whole of them once they are present (cut-through output)
+int rmRequiredBits(const rmPlan& plan, int bits);
+
+// Bit selection and bit interleaving of cb following plan. scratch and out
+// must hold rmNumWords(plan.E) words each.
+void rmRunPlan(const rmPlan& plan, const uint64_t* cb, uint64_t* scratch, uint64_t* out);
+
+// Plans keyed by their parameters, built on first use
+class rmPlanCache {
+public:
+    const rmPlan& get(int N, int rv, int Nref, int E, int Qm, int F = 0);
+
+    long long hits() const { return numHits; }
+    long long misses() const { return numMisses; }
+    int size() const { return (int)plans.size(); }
+
+private:
+    std::unordered_map<rmPlanKey, rmPlan, rmPlanKeyHash> plans;
+    long long numHits = 0;
+    long long numMisses = 0;
+};
+
+#endif // RMPLAN_H
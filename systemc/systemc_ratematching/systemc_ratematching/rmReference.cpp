@@ -0,0 +1,168 @@
+/*
+ * ==============================================
+ * File:        rmReference.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Bit-exact C++ golden reference of
+ *              nrRateMatchLDPC_modify.m. Follows the MATLAB
+ *              code step by step (repmat, circshift, find,
+ *              reshape) on one element per bit; it is meant
+ *              to be obviously right, not fast.
+ * ==============================================
+ */
+
+#include "rmReference.h"
+#include <cmath>
+
+// Lifting sizes Zc, ZcVec of the MATLAB code
+static const int ZcVec[] = {
+    2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+    18, 20, 22, 24, 26, 28, 30, 32, 36, 40, 44, 48, 52,
+    56, 60, 64, 72, 80, 88, 96, 104, 112, 120, 128, 144,
+    160, 176, 192, 208, 224, 240, 256, 288, 320, 352, 384
+};
+
+// Base graph and lifting size of an N-bit code block, false if N is not legal
+static bool baseGraph(int N, int& bgn, int& Zc) {
+    for (int z : ZcVec) {
+        if (N == z * 66) {
+            bgn = 1;
+            Zc = z;
+            return true;
+        }
+    }
+    for (int z : ZcVec) {
+        if (N == z * 50) {
+            bgn = 2;
+            Zc = z;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool rmRefLegalLength(int N) {
+    int bgn, Zc;
+    return baseGraph(N, bgn, Zc);
+}
+
+// Rate match a single code block segment as per TS 38.212 Section 5.4.2
+static std::vector<int8_t> cbsRateMatch(const std::vector<int8_t>& d, int E, int k0, int Ncb, int Qm) {
+
+    // Bit selection, Section 5.4.2.1
+    // Get number of filler bits inside the circular buffer
+    int NFillerBits = 0;
+    for (int i = 0; i < Ncb; ++i) {
+        NFillerBits += (d[i] == -1) ? 1 : 0;
+    }
+
+    // Duplicate data if more than one iteration around the circular
+    // buffer is required to obtain a total of E bits
+    std::vector<int8_t> e(E);
+    if (E == 0 || Ncb - NFillerBits <= 0) {
+        return e;
+    }
+    int copies = (int)std::ceil((double)E / (Ncb - NFillerBits));
+    std::vector<int8_t> rep((size_t)copies * Ncb);
+    for (size_t i = 0; i < rep.size(); ++i) {
+        rep[i] = d[i % Ncb];
+    }
+
+    // Shift data to start from selected redundancy version
+    std::vector<int8_t> shifted(rep.size());
+    for (size_t i = 0; i < rep.size(); ++i) {
+        shifted[i] = rep[(i + k0) % rep.size()];
+    }
+
+    // Avoid filler bits, first E that are not -1
+    int k = 0;
+    for (size_t i = 0; i < shifted.size() && k < E; ++i) {
+        if (shifted[i] != -1) {
+            e[k++] = shifted[i];
+        }
+    }
+
+    // Bit interleaving, Section 5.4.2.2: reshape to E/Qm x Qm, transpose, read out
+    std::vector<int8_t> out(E);
+    int rows = E / Qm;
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < Qm; ++j) {
+            out[i * Qm + j] = e[j * rows + i];
+        }
+    }
+    return out;
+}
+
+// Ncb and k0 of a code block
+static bool bufferParams(int N, int rv, int Nref, int& Ncb, int& k0) {
+    int bgn, Zc;
+    if (!baseGraph(N, bgn, Zc)) {
+        return false;
+    }
+
+    // Get code block soft buffer size
+    Ncb = (Nref != 0) ? ((N < Nref) ? N : Nref) : N;
+
+    // Get starting position in circular buffer
+    static const double k0Num[2][4] = { { 0, 17, 33, 56 }, { 0, 13, 25, 43 } };
+    k0 = (int)std::floor(k0Num[bgn - 1][rv & 3] * Ncb / N) * Zc;
+    return true;
+}
+
+std::vector<int8_t> rmRefRateMatchLDPC(const std::vector<int8_t>& in, int outlen, int rv, int Qm, int nlayers,
+                                       int Nref) {
+    // Output empty if input is empty or outlen is 0
+    int N = (int)in.size();
+    int Ncb, k0;
+    if (N == 0 || outlen == 0 || !bufferParams(N, rv, Nref, Ncb, k0)) {
+        return std::vector<int8_t>();
+    }
+
+    // E for all scheduled code blocks (the MATLAB condition only floors for outlen <= 0)
+    double q = (double)outlen / (nlayers * Qm);
+    int E = (1 - q - 1 >= 0) ? nlayers * Qm * (int)std::floor(q) : nlayers * Qm * (int)std::ceil(q);
+
+    return cbsRateMatch(in, E, k0, Ncb, Qm);
+}
+
+int rmRefBlockE(int G, int C, int r, int nlayers, int Qm) {
+    // If r <= C - mod(G / (nlayers * Qm), C) - 1 the floor, else the ceiling
+    double q = (double)G / (nlayers * Qm);
+    if (r <= C - std::fmod(q, C) - 1) {
+        return nlayers * Qm * (int)std::floor(q / C);
+    }
+    return nlayers * Qm * (int)std::ceil(q / C);
+}
+
+std::vector<int8_t> rmRefRateMatchTb(const std::vector<std::vector<int8_t>>& blocks, int G, int rv, int Qm,
+                                     int nlayers, int Nref) {
+    std::vector<int8_t> out;
+    int C = (int)blocks.size();
+    for (int r = 0; r < C; ++r) {
+        int N = (int)blocks[r].size();
+        int Ncb, k0;
+        if (!bufferParams(N, rv, Nref, Ncb, k0)) {
+            return std::vector<int8_t>();
+        }
+        std::vector<int8_t> e = cbsRateMatch(blocks[r], rmRefBlockE(G, C, r, nlayers, Qm), k0, Ncb, Qm);
+        out.insert(out.end(), e.begin(), e.end());
+    }
+    return out;
+}
+
+void rmRefMarkFillers(std::vector<int8_t>& d, int F) {
+    int N = (int)d.size();
+    int bgn, Zc;
+    if (F <= 0 || !baseGraph(N, bgn, Zc)) {
+        return;
+    }
+    int K = ((bgn == 1) ? 22 : 10) * Zc;
+    for (int i = K - 2 * Zc - F; i < K - 2 * Zc; ++i) {
+        if (i >= 0) {
+            d[i] = -1;
+        }
+    }
+}
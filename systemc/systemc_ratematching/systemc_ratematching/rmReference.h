@@ -0,0 +1,33 @@
+// rmReference.h
+
+#ifndef RMREFERENCE_H
+#define RMREFERENCE_H
+
+#include <cstdint>
+#include <vector>
+
+// Golden reference of the rate matching, a literal translation of
+// matlab/function/nrRateMatchLDPC_modify.m working one bit per element.
+// It shares no code with rmKernel/rmPlan, so the two check each other.
+// Input bits are 0/1, filler bits are -1.
+
+// Rate matching of one code block: nrRateMatchLDPC_modify(in, outlen, rv, Qm, nlayers, Nref).
+// Nref = 0 means no limit on the soft buffer.
+std::vector<int8_t> rmRefRateMatchLDPC(const std::vector<int8_t>& in, int outlen, int rv, int Qm, int nlayers,
+                                       int Nref = 0);
+
+// True when N is 66 Zc or 50 Zc for a lifting size Zc, the lengths the MATLAB code accepts
+bool rmRefLegalLength(int N);
+
+// Rate matching output length E of code block r of C, G bits in total (TS 38.212 5.4.2.1)
+int rmRefBlockE(int G, int C, int r, int nlayers, int Qm);
+
+// Rate matching and concatenation of the C code blocks of a transport block
+// of G bits (TS 38.212 5.4.2.1, 5.5), as nrRateMatchLDPC does
+std::vector<int8_t> rmRefRateMatchTb(const std::vector<std::vector<int8_t>>& blocks, int G, int rv, int Qm,
+                                     int nlayers, int Nref = 0);
+
+// Mark the F filler bits of a code block, the F bits before K - 2Zc, as -1
+void rmRefMarkFillers(std::vector<int8_t>& d, int F);
+
+#endif // RMREFERENCE_H
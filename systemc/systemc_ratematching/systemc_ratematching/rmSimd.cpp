@@ -0,0 +1,305 @@
+/*
+ * ==============================================
+ * File:        rmSimd.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: x86 SIMD kernels for bit interleaving and
+ *              LLR de-interleaving. 64 rows of the Qm columns
+ *              make exactly Qm output words, so both kernels
+ *              work from small per-Qm tables built once.
+ *
+ *  - Bit interleaving: output word w of a 64-row group is the
+ *    OR over columns j of pdep(rows of column j, mask of the
+ *    positions of column j in word w).
+ *  - LLR de-interleaving: 16 rows are Qm 16-byte registers;
+ *    each column is the OR of one pshufb per register.
+ * ==============================================
+ */
+
+#include "rmSimd.h"
+#include "rmKernel.h"
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RM_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RM_TARGET(isa)
+#else
+#define RM_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+const int RM_SIMD_MAX_QM = 10;
+
+#if defined(RM_X86)
+
+bool rmHaveBmi2() {
+#if defined(_MSC_VER)
+    static const bool have = [] {
+        int r[4];
+        __cpuid(r, 0);
+        if (r[0] < 7) {
+            return false;
+        }
+        __cpuidex(r, 7, 0);
+        return (r[1] & (1 << 8)) != 0;
+    }();
+#else
+    static const bool have = __builtin_cpu_supports("bmi2");
+#endif
+    return have;
+}
+
+bool rmHaveSsse3() {
+#if defined(_MSC_VER)
+    static const bool have = [] {
+        int r[4];
+        __cpuid(r, 1);
+        return (r[2] & (1 << 9)) != 0;
+    }();
+#else
+    static const bool have = __builtin_cpu_supports("ssse3");
+#endif
+    return have;
+}
+
+// Where the bits of column j sit in word w of a 64-row group
+struct rmPdepTable {
+    uint64_t mask[RM_SIMD_MAX_QM][RM_SIMD_MAX_QM];  // [w][j], MSB-first positions
+    int first[RM_SIMD_MAX_QM][RM_SIMD_MAX_QM];      // First row of column j in word w
+    int count[RM_SIMD_MAX_QM][RM_SIMD_MAX_QM];      // Rows of column j in word w
+};
+
+static const rmPdepTable& pdepTable(int Qm) {
+    static const struct Tables {
+        rmPdepTable t[RM_SIMD_MAX_QM + 1];
+        Tables() {
+            for (int Qm = 2; Qm <= RM_SIMD_MAX_QM; ++Qm) {
+                rmPdepTable& T = t[Qm];
+                for (int w = 0; w < Qm; ++w) {
+                    for (int j = 0; j < Qm; ++j) {
+                        T.mask[w][j] = 0;
+                        T.first[w][j] = -1;
+                        T.count[w][j] = 0;
+                        for (int i = 0; i < 64; ++i) {
+                            int p = i * Qm + j - 64 * w;
+                            if (p >= 0 && p < 64) {
+                                T.mask[w][j] |= 1ULL << (63 - p);
+                                if (T.first[w][j] < 0) {
+                                    T.first[w][j] = i;
+                                }
+                                ++T.count[w][j];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    } tables;
+    return tables.t[Qm];
+}
+
+RM_TARGET("bmi2")
+void rmInterleaveBitsBmi2(const uint64_t* e, int E, int Qm, uint64_t* out) {
+    const rmPdepTable& T = pdepTable(Qm);
+    int rows = E / Qm;
+    int nWords = rmNumWords(E);
+    uint64_t col[RM_SIMD_MAX_QM];
+    int o = 0;
+
+    for (int i0 = 0; i0 < rows; i0 += 64) {
+        int n = std::min(64, rows - i0);
+
+        // Next 64 rows of every column, rows past the end read as 0
+        for (int j = 0; j < Qm; ++j) {
+            col[j] = rmReadBits(e, j * rows + i0, n);
+        }
+
+        // A partial group only fills the words its rows reach
+        int words = (n == 64) ? Qm : rmNumWords(n * Qm);
+        for (int w = 0; w < words; ++w) {
+            uint64_t v = 0;
+            for (int j = 0; j < Qm; ++j) {
+                int c = T.count[w][j];
+                uint64_t bits = (col[j] << T.first[w][j]) >> (64 - c);
+                v |= _pdep_u64(bits, T.mask[w][j]);
+            }
+            out[o++] = v;
+        }
+    }
+
+    std::fill(out + o, out + nWords, 0);
+}
+
+// rmPdepTable entries as constant expressions: rows first..first + count - 1
+// of column j land in word w of a 64-row group
+constexpr int pdepFirst(int Qm, int w, int j) {
+    return (64 * w - j > 0) ? (64 * w - j + Qm - 1) / Qm : 0;
+}
+
+constexpr int pdepCount(int Qm, int w, int j) {
+    return (((64 * w + 63 - j) / Qm < 63) ? (64 * w + 63 - j) / Qm : 63) - pdepFirst(Qm, w, j) + 1;
+}
+
+constexpr uint64_t pdepMask(int Qm, int w, int j) {
+    uint64_t mask = 0;
+    for (int i = pdepFirst(Qm, w, j); i < pdepFirst(Qm, w, j) + pdepCount(Qm, w, j); ++i) {
+        mask |= 1ULL << (63 - (i * Qm + j - 64 * w));
+    }
+    return mask;
+}
+
+// Word W of a 64-row group from columns 0..J-1, unrolled so every shift and
+// mask is an immediate. Every column reaches every word for Qm <= 10.
+template <int QM, int W, int J>
+struct rmPdepWord {
+    RM_TARGET("bmi2")
+    static inline uint64_t run(const uint64_t* col) {
+        const int first = pdepFirst(QM, W, J - 1);
+        const int count = pdepCount(QM, W, J - 1);
+        const uint64_t mask = pdepMask(QM, W, J - 1);
+        return rmPdepWord<QM, W, J - 1>::run(col) | _pdep_u64((col[J - 1] << first) >> (64 - count), mask);
+    }
+};
+
+template <int QM, int W>
+struct rmPdepWord<QM, W, 0> {
+    static inline uint64_t run(const uint64_t*) { return 0; }
+};
+
+// Words 0..W-1 of a 64-row group
+template <int QM, int W>
+struct rmPdepGroup {
+    RM_TARGET("bmi2")
+    static inline void run(const uint64_t* col, uint64_t* w) {
+        rmPdepGroup<QM, W - 1>::run(col, w);
+        w[W - 1] = rmPdepWord<QM, W - 1, QM>::run(col);
+    }
+};
+
+template <int QM>
+struct rmPdepGroup<QM, 0> {
+    static inline void run(const uint64_t*, uint64_t*) {}
+};
+
+// Separate from the declaration in rmSimd.h, which has no target attribute
+template <int QM>
+RM_TARGET("bmi2")
+static void interleaveBmi2Fixed(const uint64_t* e, int E, uint64_t* out) {
+    int rows = E / QM;
+    int nWords = rmNumWords(E);
+    uint64_t col[QM];
+    uint64_t w[QM];
+    int o = 0;
+
+    for (int i0 = 0; i0 < rows; i0 += 64) {
+        int n = std::min(64, rows - i0);
+        for (int j = 0; j < QM; ++j) {
+            col[j] = rmReadBits(e, j * rows + i0, n);
+        }
+        rmPdepGroup<QM, QM>::run(col, w);
+
+        int words = (n * QM + 63) / 64;
+        std::copy(w, w + words, out + o);
+        o += words;
+    }
+
+    std::fill(out + o, out + nWords, 0);
+}
+
+template <int QM>
+void rmInterleaveBitsBmi2Fixed(const uint64_t* e, int E, uint64_t* out) {
+    interleaveBmi2Fixed<QM>(e, E, out);
+}
+
+template void rmInterleaveBitsBmi2Fixed<2>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<4>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<6>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<8>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<10>(const uint64_t*, int, uint64_t*);
+
+// pshufb controls: column j of 16 rows from register k, 0x80 where the row is elsewhere
+struct rmShuffleTable {
+    alignas(16) int8_t ctl[RM_SIMD_MAX_QM][RM_SIMD_MAX_QM][16];  // [j][k][row]
+};
+
+static const rmShuffleTable& shuffleTable(int Qm) {
+    static const struct Tables {
+        rmShuffleTable t[RM_SIMD_MAX_QM + 1];
+        Tables() {
+            for (int Qm = 2; Qm <= RM_SIMD_MAX_QM; ++Qm) {
+                for (int j = 0; j < Qm; ++j) {
+                    for (int k = 0; k < Qm; ++k) {
+                        for (int r = 0; r < 16; ++r) {
+                            int idx = r * Qm + j;
+                            t[Qm].ctl[j][k][r] = (idx / 16 == k) ? (int8_t)(idx % 16) : (int8_t)0x80;
+                        }
+                    }
+                }
+            }
+        }
+    } tables;
+    return tables.t[Qm];
+}
+
+RM_TARGET("ssse3")
+void rmDeinterleaveSsse3(const int8_t* llr, int E, int Qm, int8_t* e) {
+    const rmShuffleTable& T = shuffleTable(Qm);
+    int rows = E / Qm;
+    __m128i src[RM_SIMD_MAX_QM];
+
+    int i0 = 0;
+    for (; i0 + 16 <= rows; i0 += 16) {
+        const int8_t* p = llr + (size_t)i0 * Qm;
+        for (int k = 0; k < Qm; ++k) {
+            src[k] = _mm_loadu_si128((const __m128i*)(p + 16 * k));
+        }
+        for (int j = 0; j < Qm; ++j) {
+            __m128i v = _mm_setzero_si128();
+            for (int k = 0; k < Qm; ++k) {
+                v = _mm_or_si128(v, _mm_shuffle_epi8(src[k], _mm_load_si128((const __m128i*)T.ctl[j][k])));
+            }
+            _mm_storeu_si128((__m128i*)(e + (size_t)j * rows + i0), v);
+        }
+    }
+
+    // Remaining rows
+    for (int j = 0; j < Qm; ++j) {
+        for (int i = i0; i < rows; ++i) {
+            e[(size_t)j * rows + i] = llr[(size_t)i * Qm + j];
+        }
+    }
+}
+
+#else
+
+bool rmHaveBmi2() {
+    return false;
+}
+
+bool rmHaveSsse3() {
+    return false;
+}
+
+void rmInterleaveBitsBmi2(const uint64_t*, int, int, uint64_t*) {
+}
+
+template <int QM>
+void rmInterleaveBitsBmi2Fixed(const uint64_t*, int, uint64_t*) {
+}
+
+template void rmInterleaveBitsBmi2Fixed<2>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<4>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<6>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<8>(const uint64_t*, int, uint64_t*);
+template void rmInterleaveBitsBmi2Fixed<10>(const uint64_t*, int, uint64_t*);
+
+void rmDeinterleaveSsse3(const int8_t*, int, int, int8_t*) {
+}
+
+#endif
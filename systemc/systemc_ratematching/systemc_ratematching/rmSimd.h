@@ -0,0 +1,29 @@
+// rmSimd.h
+
+#ifndef RMSIMD_H
+#define RMSIMD_H
+
+#include <cstdint>
+
+// x86 kernels selected at run time from the CPU features. On other targets,
+// or when the CPU lacks the feature, the rmHave*() checks return false and
+// the callers keep the portable code.
+
+// CPU feature checks, evaluated once
+bool rmHaveBmi2();
+bool rmHaveSsse3();
+
+// rmInterleaveBits with BMI2 pdep, Qm in 2..10. Same result as the portable
+// version; only call when rmHaveBmi2().
+void rmInterleaveBitsBmi2(const uint64_t* e, int E, int Qm, uint64_t* out);
+
+// rmInterleaveBitsBmi2 for a fixed QM, one of 2, 4, 6, 8, 10, with the pdep
+// masks built at compile time. Only call when rmHaveBmi2().
+template <int QM>
+void rmInterleaveBitsBmi2Fixed(const uint64_t* e, int E, uint64_t* out);
+
+// rmDeinterleave<int8_t> with SSSE3 pshufb, Qm in 2..10. Only call when
+// rmHaveSsse3().
+void rmDeinterleaveSsse3(const int8_t* llr, int E, int Qm, int8_t* e);
+
+#endif // RMSIMD_H
@@ -0,0 +1,173 @@
+/*
+ * ==============================================
+ * File:        rmStats.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: SystemC-free performance counters: handshake
+ *              beats and stalls per interface, FIFO occupancy
+ *              histograms and latency distributions, and the
+ *              CSV / JSON report they are written to at the
+ *              end of a simulation.
+ * ==============================================
+ */
+
+#include "rmStats.h"
+#include <fstream>
+#include <iostream>
+
+void rmStreamStats::sample(bool valid, bool ready) {
+    if (valid && ready) {
+        if (firstBeat < 0) {
+            firstBeat = cycles;
+        }
+        lastBeat = cycles;
+        ++beats;
+    }
+    else if (valid) {
+        ++stallCycles;
+    }
+    else if (ready) {
+        ++idleCycles;
+    }
+    ++cycles;
+}
+
+double rmStreamStats::beatsPerCycle() const {
+    return (beats > 0) ? (double)beats / (lastBeat - firstBeat + 1) : 0.0;
+}
+
+void rmOccupancyStats::sample(size_t n) {
+    if (cycles.size() <= n) {
+        cycles.resize(n + 1, 0);
+    }
+    ++cycles[n];
+}
+
+double rmOccupancyStats::mean() const {
+    long long total = 0, weighted = 0;
+    for (size_t n = 0; n < cycles.size(); ++n) {
+        total += cycles[n];
+        weighted += (long long)n * cycles[n];
+    }
+    return (total > 0) ? (double)weighted / total : 0.0;
+}
+
+int rmOccupancyStats::max() const {
+    for (size_t n = cycles.size(); n > 0; --n) {
+        if (cycles[n - 1] != 0) {
+            return (int)n - 1;
+        }
+    }
+    return 0;
+}
+
+void rmLatencyStats::add(long long cycles) {
+    if (count == 0 || cycles < min) {
+        min = cycles;
+    }
+    if (count == 0 || cycles > max) {
+        max = cycles;
+    }
+    ++count;
+    sum += cycles;
+    ++histogram[cycles];
+}
+
+double rmLatencyStats::mean() const {
+    return (count > 0) ? (double)sum / count : 0.0;
+}
+
+void rmStatsReport::add(const std::string& module, const std::string& metric, double value) {
+    rows.push_back({ module, metric, std::string(), value });
+}
+
+void rmStatsReport::addBin(const std::string& module, const std::string& metric, long long bin, double value) {
+    rows.push_back({ module, metric, std::to_string(bin), value });
+}
+
+void rmStatsReport::add(const std::string& module, const std::string& prefix, const rmStreamStats& s) {
+    add(module, prefix + "_beats", (double)s.beats);
+    add(module, prefix + "_cycles", (double)s.cycles);
+    add(module, prefix + "_stall_cycles", (double)s.stallCycles);
+    add(module, prefix + "_idle_cycles", (double)s.idleCycles);
+    add(module, prefix + "_beats_per_cycle", s.beatsPerCycle());
+}
+
+void rmStatsReport::add(const std::string& module, const std::string& metric, const rmOccupancyStats& s) {
+    add(module, metric + "_mean", s.mean());
+    add(module, metric + "_max", (double)s.max());
+    for (size_t n = 0; n < s.cycles.size(); ++n) {
+        addBin(module, metric + "_histogram", (long long)n, (double)s.cycles[n]);
+    }
+}
+
+void rmStatsReport::add(const std::string& module, const std::string& metric, const rmLatencyStats& s) {
+    add(module, metric + "_count", (double)s.count);
+    add(module, metric + "_min", (double)s.min);
+    add(module, metric + "_mean", s.mean());
+    add(module, metric + "_max", (double)s.max);
+    for (const auto& bin : s.histogram) {
+        addBin(module, metric + "_histogram", bin.first, (double)bin.second);
+    }
+}
+
+bool rmStatsReport::write(const std::string& path) const {
+    bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    return json ? writeJson(path) : writeCsv(path);
+}
+
+bool rmStatsReport::writeCsv(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot write statistics file: " << path << std::endl;
+        return false;
+    }
+    file.precision(12);
+    file << "module,metric,bin,value\n";
+    for (const row& r : rows) {
+        file << r.module << ',' << r.metric << ',' << r.bin << ',' << r.value << '\n';
+    }
+    return (bool)file;
+}
+
+bool rmStatsReport::writeJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot write statistics file: " << path << std::endl;
+        return false;
+    }
+
+    // Rows come grouped by module, and the bins of a histogram one after the other
+    file.precision(12);
+    file << "{";
+    for (size_t i = 0; i < rows.size(); ++i) {
+        const row& r = rows[i];
+        bool newModule = (i == 0 || rows[i - 1].module != r.module);
+        bool newMetric = newModule || rows[i - 1].metric != r.metric;
+        bool endMetric = (i + 1 == rows.size() || rows[i + 1].module != r.module || rows[i + 1].metric != r.metric);
+
+        if (newModule) {
+            file << ((i == 0) ? "\n" : "\n  },\n") << "  \"" << r.module << "\": {";
+        }
+        if (newMetric) {
+            file << (newModule ? "\n" : ",\n") << "    \"" << r.metric << "\": ";
+            if (!r.bin.empty()) {
+                file << "{";
+            }
+        }
+        if (r.bin.empty()) {
+            file << r.value;
+        }
+        else {
+            file << (newMetric ? "" : ", ") << "\"" << r.bin << "\": " << r.value;
+            if (endMetric) {
+                file << "}";
+            }
+        }
+    }
+    file << (rows.empty() ? "}\n" : "\n  }\n}\n");
+    return (bool)file;
+}
@@ -0,0 +1,72 @@
+// rmStats.h
+
+#ifndef RMSTATS_H
+#define RMSTATS_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Handshake counters of one ready/valid interface, sampled once per clock cycle
+struct rmStreamStats {
+    long long cycles = 0;                  // Cycles sampled
+    long long beats = 0;                   // valid and ready
+    long long stallCycles = 0;             // valid without ready
+    long long idleCycles = 0;              // ready without valid
+    long long firstBeat = -1;              // Sampled cycle of the first beat
+    long long lastBeat = -1;               // Sampled cycle of the last beat
+
+    void sample(bool valid, bool ready);
+
+    // Beats over the cycles from the first to the last beat
+    double beatsPerCycle() const;
+};
+
+// Cycles spent at each occupancy of a FIFO
+struct rmOccupancyStats {
+    std::vector<long long> cycles;         // cycles[n] = cycles with n entries
+
+    void sample(size_t n);
+    double mean() const;
+    int max() const;
+};
+
+// Distribution of a latency in cycles
+struct rmLatencyStats {
+    long long count = 0;
+    long long sum = 0;
+    long long min = 0;
+    long long max = 0;
+    std::map<long long, long long> histogram;   // Latency -> occurrences
+
+    void add(long long cycles);
+    double mean() const;
+};
+
+// Named metrics of the modules, written at the end of a simulation as CSV
+// (module,metric,bin,value) or as JSON with one object per module
+class rmStatsReport {
+public:
+    void add(const std::string& module, const std::string& metric, double value);
+    void add(const std::string& module, const std::string& prefix, const rmStreamStats& s);
+    void add(const std::string& module, const std::string& metric, const rmOccupancyStats& s);
+    void add(const std::string& module, const std::string& metric, const rmLatencyStats& s);
+
+    // JSON when the path ends in ".json", CSV otherwise
+    bool write(const std::string& path) const;
+
+private:
+    struct row {
+        std::string module, metric;
+        std::string bin;                   // Histogram bin, empty for a scalar
+        double value;
+    };
+    std::vector<row> rows;
+
+    void addBin(const std::string& module, const std::string& metric, long long bin, double value);
+    bool writeCsv(const std::string& path) const;
+    bool writeJson(const std::string& path) const;
+};
+
+#endif // RMSTATS_H
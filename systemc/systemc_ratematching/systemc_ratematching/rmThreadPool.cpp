@@ -0,0 +1,116 @@
+/*
+ * ==============================================
+ * File:        rmThreadPool.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Work-stealing thread pool used by the
+ *              parallel batch rate matching.
+ * ==============================================
+ */
+
+#include "rmThreadPool.h"
+#include <algorithm>
+
+rmThreadPool::rmThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    for (int i = 0; i < threads; ++i) {
+        queues.emplace_back(new Queue);
+    }
+    for (int i = 0; i < threads; ++i) {
+        workers.emplace_back(&rmThreadPool::workerLoop, this, i);
+    }
+}
+
+rmThreadPool::~rmThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m);
+        stop = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+}
+
+void rmThreadPool::parallelFor(int n, const std::function<void(int, int)>& fn) {
+    if (n <= 0) {
+        return;
+    }
+
+    // The task is published before any of its indices can be taken
+    {
+        std::lock_guard<std::mutex> lock(m);
+        task = &fn;
+        remaining = n;
+    }
+
+    // Contiguous ranges of indices per worker, so neighbouring tasks start on one thread
+    int W = size();
+    for (int w = 0; w < W; ++w) {
+        std::lock_guard<std::mutex> lock(queues[w]->m);
+        for (int i = (int)((long long)n * w / W); i < (int)((long long)n * (w + 1) / W); ++i) {
+            queues[w]->items.push_back(i);
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m);
+    ++generation;
+    wake.notify_all();
+    done.wait(lock, [this] { return remaining == 0; });
+    task = nullptr;
+}
+
+bool rmThreadPool::take(int worker, int& item) {
+    // Own queue first, newest index first
+    {
+        Queue& q = *queues[worker];
+        std::lock_guard<std::mutex> lock(q.m);
+        if (!q.items.empty()) {
+            item = q.items.back();
+            q.items.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest index of another worker
+    int W = size();
+    for (int k = 1; k < W; ++k) {
+        Queue& q = *queues[(worker + k) % W];
+        std::lock_guard<std::mutex> lock(q.m);
+        if (!q.items.empty()) {
+            item = q.items.front();
+            q.items.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void rmThreadPool::workerLoop(int worker) {
+    long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m);
+            wake.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) {
+                return;
+            }
+            seen = generation;
+        }
+
+        // An index is only queued once its task is set, so task is read after taking it
+        int item;
+        while (take(worker, item)) {
+            (*task)(item, worker);
+            if (--remaining == 0) {
+                std::lock_guard<std::mutex> lock(m);
+                done.notify_all();
+            }
+        }
+    }
+}
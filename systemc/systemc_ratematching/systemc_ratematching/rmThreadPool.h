@@ -0,0 +1,54 @@
+// rmThreadPool.h
+
+#ifndef RMTHREADPOOL_H
+#define RMTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads, each with its own queue of task indices. A
+// worker takes from the back of its own queue and, once that is empty,
+// steals from the front of the others.
+class rmThreadPool {
+public:
+    // threads = 0 uses one worker per hardware thread
+    explicit rmThreadPool(int threads = 0);
+    ~rmThreadPool();
+
+    rmThreadPool(const rmThreadPool&) = delete;
+    rmThreadPool& operator=(const rmThreadPool&) = delete;
+
+    int size() const { return (int)workers.size(); }
+
+    // Run task(i, worker) for every i in [0, n) and wait for all of them.
+    // worker is the index of the thread running the task, in [0, size()).
+    void parallelFor(int n, const std::function<void(int, int)>& task);
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<int> items;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues;
+
+    std::mutex m;
+    std::condition_variable wake;       // New work or stop
+    std::condition_variable done;       // Last task of a parallelFor finished
+    const std::function<void(int, int)>* task = nullptr;
+    long long generation = 0;
+    bool stop = false;
+    std::atomic<int> remaining{ 0 };
+
+    bool take(int worker, int& item);
+    void workerLoop(int worker);
+};
+
+#endif // RMTHREADPOOL_H
@@ -0,0 +1,444 @@
+/*
+ * ==============================================
+ * File:        rmVector.cpp
+ * Author:      Nguyen Thi Hoai Linh
+ * Email:       linhnth@hnsoc.one
+ * Date Created:
+ * Last Modified: 16 October 2026
+ * Version:     1.0
+ * Description: Test vector I/O without SystemC: the
+ *              configuration and 128-bit line text files,
+ *              and the binary vector format, which is read
+ *              from a memory mapping (or streamed) instead
+ *              of being parsed a character at a time.
+ * ==============================================
+ */
+
+#include "rmVector.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const size_t FILE_HEADER_SIZE = 16;
+static const size_t BEAT_SIZE = 2 * sizeof(uint64_t);
+
+static_assert(sizeof(rmVectorRecord) == 40, "record header is 40 bytes in the file");
+
+// The file is little-endian, fields are swapped only on a big-endian host
+static bool hostLittleEndian() {
+    const uint32_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+static const bool littleEndian = hostLittleEndian();
+
+static uint32_t swap32(uint32_t v) {
+    return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+}
+
+static uint64_t swap64(uint64_t v) {
+    return ((uint64_t)swap32((uint32_t)v) << 32) | swap32((uint32_t)(v >> 32));
+}
+
+// Host to file byte order and back, the same swap
+static void fileOrder(rmVectorRecord& rec) {
+    if (littleEndian) {
+        return;
+    }
+    uint32_t* f[] = { &rec.inlen, &rec.outlen, &rec.rv, &rec.nlayers, &rec.Qm,
+                      &rec.Nref, &rec.C, &rec.G, &rec.F, &rec.beats };
+    for (uint32_t* v : f) {
+        *v = swap32(*v);
+    }
+}
+
+static void fileOrder(uint64_t* words, size_t n) {
+    if (littleEndian) {
+        return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        words[i] = swap64(words[i]);
+    }
+}
+
+bool rmReadConfigText(const std::string& path, std::vector<rmVectorRecord>& configs) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+
+    rmVectorRecord config;
+    std::set<std::string> seen;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        long value;
+
+        if (std::getline(iss, key, ':') && iss >> value) {
+            // Remove whitespace
+            key.erase(std::remove(key.begin(), key.end(), ' '), key.end());
+
+            if (seen.count(key) != 0) {
+                configs.push_back(config);
+                config = rmVectorRecord();
+                seen.clear();
+            }
+            seen.insert(key);
+
+            uint32_t v = (uint32_t)value;
+            if (key == "input_length") {
+                config.inlen = v;
+            }
+            else if (key == "output_length") {
+                config.outlen = v;
+            }
+            else if (key == "redundancy_version") {
+                config.rv = v;
+            }
+            else if (key == "layer") {
+                config.nlayers = v;
+            }
+            else if (key == "modulation_type") {
+                config.Qm = v;
+            }
+            else if (key == "Nref") {
+                config.Nref = v;
+            }
+            else if (key == "code_blocks") {
+                config.C = v;
+            }
+            else if (key == "tb_output_length") {
+                config.G = v;
+            }
+            else if (key == "filler_bits") {
+                config.F = v;
+            }
+            else {
+                std::cerr << "Warning: Unrecognized key in config file: " << key << std::endl;
+            }
+        }
+        else if (!line.empty() && line != "\r") {
+            std::cerr << "Warning: Incorrect format in line: " << line << std::endl;
+        }
+    }
+    if (!seen.empty()) {
+        configs.push_back(config);
+    }
+    return true;
+}
+
+bool rmParseLine(const char* s, size_t len, uint64_t& hi, uint64_t& lo) {
+    if (len != 128) {
+        return false;
+    }
+    uint64_t w[2] = { 0, 0 };
+    unsigned bad = 0;
+    for (int i = 0; i < 128; ++i) {
+        unsigned b = (unsigned)(s[i] - '0');
+        bad |= b;
+        w[i >> 6] = (w[i >> 6] << 1) | (b & 1);
+    }
+    hi = w[0];
+    lo = w[1];
+    return (bad & ~1u) == 0;
+}
+
+bool rmReadTextLines(const std::string& path, std::vector<uint64_t>& words) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t len = line.length();
+        if (len != 0 && line[len - 1] == '\r') {
+            --len;
+        }
+        uint64_t hi, lo;
+        if (rmParseLine(line.data(), len, hi, lo)) {
+            words.push_back(hi);
+            words.push_back(lo);
+        }
+        else if (len != 0) {
+            std::cerr << "Warning: Skipping invalid line of length " << len << std::endl;
+        }
+    }
+    return true;
+}
+
+void rmFormatLine(uint64_t hi, uint64_t lo, char* s) {
+    for (int i = 0; i < 64; ++i) {
+        s[i] = (char)('0' + ((hi >> (63 - i)) & 1));
+        s[64 + i] = (char)('0' + ((lo >> (63 - i)) & 1));
+    }
+    s[128] = '\0';
+}
+
+/*************** Writer **************/
+bool rmVectorWriter::open(const std::string& path) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+    unsigned char header[FILE_HEADER_SIZE] = {};
+    uint32_t version = littleEndian ? RM_VECTOR_VERSION : swap32(RM_VECTOR_VERSION);
+    std::memcpy(header, RM_VECTOR_MAGIC, 4);
+    std::memcpy(header + 4, &version, 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    return file.good();
+}
+
+void rmVectorWriter::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+bool rmVectorWriter::write(const rmVectorRecord& rec, const uint64_t* words) {
+    rmVectorRecord header = rec;
+    fileOrder(header);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (littleEndian) {
+        file.write(reinterpret_cast<const char*>(words), (std::streamsize)(rec.beats * BEAT_SIZE));
+    }
+    else {
+        std::vector<uint64_t> swapped(words, words + 2 * (size_t)rec.beats);
+        fileOrder(swapped.data(), swapped.size());
+        file.write(reinterpret_cast<const char*>(swapped.data()), (std::streamsize)(rec.beats * BEAT_SIZE));
+    }
+    return file.good();
+}
+
+bool rmBeatWriter::open(const std::string& path) {
+    close();
+    binary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".rmv") == 0;
+    if (binary) {
+        return vectors.open(path);
+    }
+    text.open(path);
+    if (!text.is_open()) {
+        std::cerr << "Error: Could not open file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void rmBeatWriter::close() {
+    if (binary) {
+        if (!pending.empty()) {
+            endTransportBlock();
+        }
+        vectors.close();
+    }
+    else if (text.is_open()) {
+        text.close();
+    }
+}
+
+void rmBeatWriter::write(uint64_t hi, uint64_t lo) {
+    if (binary) {
+        pending.push_back(hi);
+        pending.push_back(lo);
+        return;
+    }
+    char line[130];
+    rmFormatLine(hi, lo, line);
+    line[128] = '\n';
+    text.write(line, 129);
+}
+
+void rmBeatWriter::endTransportBlock() {
+    if (binary && vectors.isOpen()) {
+        rmVectorRecord rec;
+        rec.beats = (uint32_t)(pending.size() / 2);
+        vectors.write(rec, pending.data());
+    }
+    pending.clear();
+}
+
+/*************** Reader **************/
+bool rmVectorReader::mapFileData(const std::string& path) {
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    HANDLE m = nullptr;
+    const void* view = nullptr;
+    if (GetFileSizeEx(f, &size) && size.QuadPart > 0) {
+        m = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m != nullptr) {
+            view = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+    if (view == nullptr) {
+        if (m != nullptr) {
+            CloseHandle(m);
+        }
+        CloseHandle(f);
+        return false;
+    }
+    mapFile = f;
+    mapHandle = m;
+    mapData = static_cast<const unsigned char*>(view);
+    mapSize = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd); // The mapping keeps the file open
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+    mapData = static_cast<const unsigned char*>(view);
+    mapSize = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void rmVectorReader::unmapFileData() {
+    if (mapData == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(mapData);
+    CloseHandle(static_cast<HANDLE>(mapHandle));
+    CloseHandle(static_cast<HANDLE>(mapFile));
+#else
+    munmap(const_cast<unsigned char*>(mapData), mapSize);
+#endif
+    mapData = nullptr;
+    mapSize = 0;
+    mapFile = nullptr;
+    mapHandle = nullptr;
+}
+
+bool rmVectorReader::open(const std::string& path) {
+    close();
+    if (!mapFileData(path)) {
+        file.open(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file " << path << std::endl;
+            return false;
+        }
+    }
+    if (!rewind()) {
+        std::cerr << "Error: Not a rate matching vector file: " << path << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void rmVectorReader::close() {
+    unmapFileData();
+    if (file.is_open()) {
+        file.close();
+    }
+    beatsLeft = 0;
+}
+
+bool rmVectorReader::rewind() {
+    unsigned char header[FILE_HEADER_SIZE];
+    beatsLeft = 0;
+    if (mapData != nullptr) {
+        if (mapSize < FILE_HEADER_SIZE) {
+            return false;
+        }
+        std::memcpy(header, mapData, FILE_HEADER_SIZE);
+        mapPos = FILE_HEADER_SIZE;
+    }
+    else {
+        file.clear();
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(header), FILE_HEADER_SIZE)) {
+            return false;
+        }
+    }
+    uint32_t version;
+    std::memcpy(&version, header + 4, 4);
+    if (!littleEndian) {
+        version = swap32(version);
+    }
+    return std::memcmp(header, RM_VECTOR_MAGIC, 4) == 0 && version == RM_VECTOR_VERSION;
+}
+
+bool rmVectorReader::next(rmVectorRecord& rec) {
+    if (mapData != nullptr) {
+        mapPos += (size_t)beatsLeft * BEAT_SIZE;
+        beatsLeft = 0;
+        if (mapPos + sizeof(rec) > mapSize) {
+            return false;
+        }
+        std::memcpy(&rec, mapData + mapPos, sizeof(rec));
+        fileOrder(rec);
+        mapPos += sizeof(rec);
+        if ((mapSize - mapPos) / BEAT_SIZE < rec.beats) {
+            std::cerr << "Error: Vector file ends inside a record" << std::endl;
+            return false;
+        }
+    }
+    else {
+        if (beatsLeft != 0) {
+            file.seekg((std::streamoff)beatsLeft * BEAT_SIZE, std::ios::cur);
+            beatsLeft = 0;
+        }
+        if (!file.read(reinterpret_cast<char*>(&rec), sizeof(rec))) {
+            return false;
+        }
+        fileOrder(rec);
+    }
+    beatsLeft = rec.beats;
+    return true;
+}
+
+int rmVectorReader::read(uint64_t* words, int maxBeats) {
+    int n = (int)std::min<uint32_t>(beatsLeft, (uint32_t)std::max(maxBeats, 0));
+    if (n == 0) {
+        return 0;
+    }
+    if (mapData != nullptr) {
+        std::memcpy(words, mapData + mapPos, n * BEAT_SIZE);
+        mapPos += n * BEAT_SIZE;
+    }
+    else if (!file.read(reinterpret_cast<char*>(words), (std::streamsize)(n * BEAT_SIZE))) {
+        std::cerr << "Error: Vector file ends inside a record" << std::endl;
+        beatsLeft = 0;
+        return 0;
+    }
+    fileOrder(words, 2 * (size_t)n);
+    beatsLeft -= n;
+    return n;
+}
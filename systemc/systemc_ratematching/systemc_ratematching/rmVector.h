@@ -0,0 +1,127 @@
+// rmVector.h
+
+#ifndef RMVECTOR_H
+#define RMVECTOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Binary test vector file (.rmv): a 16-byte file header, then one record per
+// transport block. A record is a 40-byte header with the configuration and
+// the beat count, followed by the beats as two 64-bit words each (first 64
+// bits of the beat first, rmKernel bit order). All fields are little-endian,
+// byte-swapped on the way in and out on a big-endian host, and every record
+// starts 8-byte aligned, so a mapped file is read in place.
+
+const char RM_VECTOR_MAGIC[4] = { 'R', 'M', 'V', '1' };
+const uint32_t RM_VECTOR_VERSION = 1;
+
+// Record header, same fields as the configuration text file
+struct rmVectorRecord {
+    uint32_t inlen = 0;       // input_length
+    uint32_t outlen = 0;      // output_length
+    uint32_t rv = 0;          // redundancy_version
+    uint32_t nlayers = 0;     // layer
+    uint32_t Qm = 0;          // modulation_type
+    uint32_t Nref = 0;        // Nref
+    uint32_t C = 0;           // code_blocks, 0 = single block
+    uint32_t G = 0;           // tb_output_length
+    uint32_t F = 0;           // filler_bits
+    uint32_t beats = 0;       // 128-bit beats following the header
+
+    // Code blocks of the transport block, 1 in single block mode
+    int codeBlocks() const { return (C != 0) ? (int)C : 1; }
+
+    // Output bits of the transport block, outlen in single block mode
+    int tbOutputBits() const { return (C != 0) ? (int)G : (int)outlen; }
+};
+
+// Read a configuration text file ("key: value" lines, a key that repeats
+// starts the next configuration). Returns false if it cannot be opened.
+bool rmReadConfigText(const std::string& path, std::vector<rmVectorRecord>& configs);
+
+// Parse one line of 128 '0'/'1' characters into two words
+bool rmParseLine(const char* s, size_t len, uint64_t& hi, uint64_t& lo);
+
+// Append the 128-bit lines of a text file (io/input format and MATLAB
+// save_128bit_per_line output) to words, two words per line
+bool rmReadTextLines(const std::string& path, std::vector<uint64_t>& words);
+
+// Format two words as a line of 128 '0'/'1' characters, s holds 129 chars
+void rmFormatLine(uint64_t hi, uint64_t lo, char* s);
+
+// Writes a vector file record by record
+class rmVectorWriter {
+public:
+    bool open(const std::string& path);
+    bool isOpen() const { return file.is_open(); }
+    void close();
+
+    // Append a record followed by rec.beats beats from words
+    bool write(const rmVectorRecord& rec, const uint64_t* words);
+
+private:
+    std::ofstream file;
+};
+
+// Testbench output: 128-bit text lines, or a vector file when the path ends
+// in ".rmv". Output records hold one transport block each, with only the
+// beat count of the header filled in.
+class rmBeatWriter {
+public:
+    bool open(const std::string& path);
+    bool isOpen() const { return binary ? vectors.isOpen() : text.is_open(); }
+    void close();
+
+    // Append one beat to the current transport block
+    void write(uint64_t hi, uint64_t lo);
+
+    // End the current transport block
+    void endTransportBlock();
+
+private:
+    bool binary = false;
+    std::ofstream text;
+    rmVectorWriter vectors;
+    std::vector<uint64_t> pending;   // Beats of the current transport block (binary)
+};
+
+// Reads a vector file record by record. The file is memory-mapped when the
+// platform allows it, otherwise streamed, so only the beats asked for are
+// held in memory.
+class rmVectorReader {
+public:
+    ~rmVectorReader() { close(); }
+
+    bool open(const std::string& path);
+    bool isOpen() const { return mapData != nullptr || file.is_open(); }
+    bool mapped() const { return mapData != nullptr; }
+    void close();
+
+    // Go back to the first record
+    bool rewind();
+
+    // Advance to the next record header, skipping the unread beats of the current one
+    bool next(rmVectorRecord& rec);
+
+    // Copy up to maxBeats beats of the current record to words, returns the beats read
+    int read(uint64_t* words, int maxBeats);
+
+private:
+    const unsigned char* mapData = nullptr;
+    size_t mapSize = 0;
+    size_t mapPos = 0;
+    void* mapFile = nullptr;      // Platform handles of the mapping
+    void* mapHandle = nullptr;
+
+    std::ifstream file;
+    uint32_t beatsLeft = 0;       // Unread beats of the current record
+
+    bool mapFileData(const std::string& path);
+    void unmapFileData();
+};
+
+#endif // RMVECTOR_H